@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QWidget>
+#include <QPainter>
+#include <QPointF>
+#include <QVector>
+#include <QHash>
+#include <QString>
+
+// Cumulative kilometres over time plotted against the ideal pacer line.
+// X values are Julian day numbers, Y values are cumulative kilometres.
+class CumulativeChartWidget : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit CumulativeChartWidget(QWidget *parent = nullptr);
+    
+    // Points must be sorted by date. The pacer line starts at zero on
+    // pacerOriginDay and grows by pacerKmPerDay. Zoom and pan are kept
+    // across calls.
+    void setSeries(QVector<QPointF> points, double pacerOriginDay, double pacerKmPerDay);
+    
+    // Adds a point after the last one without rebuilding the series. Returns
+    // false if the series is empty or the point would go before its end.
+    bool appendPoint(const QPointF& point);
+    
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private:
+    QRectF plotRect() const;
+    double visibleSpan() const;
+    void clampViewStart();
+    const QVector<QPointF>& pointsForZoomLevel(int level);
+    double pacerKmAt(double day) const;
+    double fullSpan() const;
+    void updateAxisLabels(double viewStart, double viewEnd, double yMin, double yMax);
+    
+    QVector<QPointF> m_points;
+    double m_pacer_origin;
+    double m_pacer_km_per_day;
+    
+    // View state: span shrinks by half with every zoom level
+    int m_zoom_level;
+    double m_view_start;
+    double m_drag_last_x;
+    
+    // Downsampled series per zoom level, valid for plots up to m_cache_width pixels
+    QHash<int, QVector<QPointF>> m_lod_cache;
+    int m_cache_width;
+    
+    // Reused between frames; the point buffer keeps its capacity and labels are
+    // only reformatted when the value they show changes
+    QVector<QPointF> m_screen_points;
+    qint64 m_start_label_day;
+    qint64 m_end_label_day;
+    qint64 m_y_min_label_km;
+    qint64 m_y_max_label_km;
+    QString m_start_label;
+    QString m_end_label;
+    QString m_y_min_label;
+    QString m_y_max_label;
+};
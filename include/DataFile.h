@@ -0,0 +1,16 @@
+#pragma once
+
+#include "RunningEntry.h"
+#include "StatsCache.h"
+#include <QString>
+#include <vector>
+
+// Entries parsed from the data file together with the stamp of what was read
+struct DataFileContents {
+    std::vector<RunningEntry> entries;
+    DataFileStamp stamp;
+};
+
+// Reads and hashes the data file. Safe to call from a worker thread.
+// A missing file yields no entries and a stamp that does not exist.
+DataFileContents read_data_file(const QString& path);
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QDialog>
+#include <QPlainTextEdit>
+#include <QComboBox>
+#include <QCheckBox>
+#include <QLabel>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QDialogButtonBox>
+#include "RunningEntry.h"
+#include <vector>
+
+// Bulk import of runs pasted as text or read from another app's CSV export.
+// Rows are validated in parallel and every error is listed in one table;
+// the caller commits accepted_entries() in a single batch.
+class ImportDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    explicit ImportDialog(QWidget *parent = nullptr);
+    
+    // Valid rows from the last validation, sorted by date
+    const std::vector<RunningEntry>& accepted_entries() const;
+
+private slots:
+    void on_open_file_clicked();
+    void on_validate_clicked();
+    void on_input_changed();
+    void on_layout_changed();
+
+private:
+    void setup_ui();
+    void show_summary(const QString& text);
+    
+    QPlainTextEdit *m_input_edit;
+    QComboBox *m_layout_combo;
+    QCheckBox *m_header_check;
+    QComboBox *m_date_format_combo;
+    QComboBox *m_unit_combo;
+    QPushButton *m_open_button;
+    QPushButton *m_validate_button;
+    QTableWidget *m_results_table;
+    QLabel *m_summary_label;
+    QDialogButtonBox *m_button_box;
+    
+    std::vector<RunningEntry> m_accepted;
+};
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <QPointF>
+#include <QVector>
+
+// Largest-Triangle-Three-Buckets downsampling. Points must be sorted by x.
+// Returns at most `threshold` points that keep the visual shape of the series;
+// the input is returned unchanged when it is already small enough.
+QVector<QPointF> lttb_downsample(const QVector<QPointF>& points, int threshold);
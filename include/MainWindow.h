@@ -9,35 +9,53 @@
 #include <QTextEdit>
 #include <QMessageBox>
 #include <QDateEdit>
+#include <QFutureWatcher>
+#include "RunningEntry.h"
+#include "RunningStats.h"
+#include "StatsCache.h"
+#include "DataFile.h"
 #include "TrackWidget.h"
+#include "CumulativeChartWidget.h"
+#include "StatsServer.h"
 #include <vector>
 #include <string>
 
-struct RunningEntry {
-    std::string date;
-    double kilometers;
-    
-    RunningEntry(std::string d, double km) : date(std::move(d)), kilometers(km) {}
-};
-
 class MainWindow : public QMainWindow {
     Q_OBJECT
+    
+    // Tests drive the widgets and refresh path directly
+    friend class InputLatencyTest;
+    friend class AllocationTest;
+    friend class CacheReloadTest;
 
 public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow() override = default;
+    
+    // Serves statistics as JSON on localhost:port until the window closes
+    void start_stats_server(quint16 port);
 
 private slots:
     void on_add_button_clicked();
     void on_remove_last_button_clicked();
+    void on_import_button_clicked();
+    void on_background_load_finished();
 
 private:
     // Helper methods
     void update_list_view();
-    void update_statistics();
+    void compute_statistics(RunningStats& stats) const;
+    void fill_derived_statistics(RunningStats& stats) const;
+    void show_statistics(const RunningStats& stats);
+    void publish_statistics(const RunningStats& stats);
+    void update_chart();
+    bool append_to_chart();
     void setup_ui();
-    void save_to_file();
+    void save_to_file(const RunningStats& stats);
     void load_from_file();
+    bool load_cached_statistics(RunningStats& stats);
+    void start_background_load();
+    void set_input_enabled(bool enabled);
     void save_and_update_ui();
     int get_day_of_year() const;
 
@@ -46,7 +64,9 @@ private:
     QLineEdit *m_kilometers_entry;
     QPushButton *m_add_button;
     QPushButton *m_remove_last_button;
+    QPushButton *m_import_button;
     TrackWidget *m_track_widget;
+    CumulativeChartWidget *m_chart_widget;
     QLabel *m_total_label;
     QLabel *m_count_label;
     QLabel *m_daily_avg_label;
@@ -56,4 +76,29 @@ private:
     // Data storage
     std::vector<RunningEntry> m_entries;
     QString m_data_file;
+    DataFileStamp m_data_stamp;
+    RunningStats m_stats;
+    QFutureWatcher<DataFileContents> m_load_watcher;
+    
+    // Last text shown, so unchanged refreshes skip setText() and setPlainText()
+    std::string m_total_text;
+    std::string m_count_text;
+    std::string m_pacer_text;
+    std::string m_goal_text;
+    std::string m_list_text;
+    std::string m_list_scratch;
+    
+    // Kept between refreshes and saves so their capacity is reused
+    std::vector<const RunningEntry*> m_chart_order;
+    std::string m_file_text;
+    
+    // Entries already plotted and where the series ends, so adds can append.
+    // Cleared whenever entries are removed or replaced rather than appended.
+    bool m_chart_valid;
+    size_t m_chart_entry_count;
+    double m_chart_total_km;
+    qint64 m_chart_last_day;
+    
+    // Optional local stats endpoint
+    StatsServer *m_stats_server;
 };
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <string>
+
+struct RunningEntry {
+    std::string date;
+    double kilometers;
+    
+    RunningEntry(std::string d, double km) : date(std::move(d)), kilometers(km) {}
+};
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+struct RunningStats {
+    // Aggregates over all entries, persisted in the statistics cache
+    double total = 0.0;
+    int entry_count = 0;
+    int days_tracked = 0;
+    std::string earliest;
+    std::string latest;
+    std::map<std::string, double> monthly_km;  // "yyyy-MM" -> km
+    
+    // Derived from the aggregates and today's date
+    double daily_average = 0.0;
+    double progress_percent = 0.0;
+    double pacer_km = 0.0;
+};
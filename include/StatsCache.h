@@ -0,0 +1,36 @@
+#pragma once
+
+#include "RunningStats.h"
+#include <QString>
+#include <QByteArray>
+#include <QtGlobal>
+
+// Identifies one version of the data file. The hash is only known once the
+// file has been read; size and mtime are cheap enough to check at startup.
+struct DataFileStamp {
+    qint64 size = -1;
+    qint64 mtime_ms = 0;
+    QByteArray hash;
+    
+    bool exists() const { return size >= 0; }
+};
+
+// Size and mtime of the file at path, size is -1 if it does not exist
+DataFileStamp stat_data_file(const QString& path);
+
+// Hex SHA-1 of the data file contents
+QByteArray hash_data_file_contents(const QByteArray& contents);
+
+// Sidecar file holding the aggregates of RunningStats next to the data file
+QString stats_cache_path(const QString& data_file);
+
+// Returns false if the cache is missing, unreadable or written by another version
+bool read_stats_cache(const QString& path, DataFileStamp& stamp, RunningStats& stats);
+bool write_stats_cache(const QString& path, const DataFileStamp& stamp, const RunningStats& stats);
+
+// Reads the cache for data_file if it still describes it by size and mtime.
+// Contents edited without changing either are caught by stats_cache_confirmed.
+bool load_stats_cache(const QString& data_file, DataFileStamp& stamp, RunningStats& stats);
+
+// True if the file read in full is the one the cache was written for
+bool stats_cache_confirmed(const DataFileStamp& cached, const DataFileStamp& loaded);
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QThread>
+#include <atomic>
+#include <memory>
+
+class QTcpServer;
+class QTcpSocket;
+
+// Read-only HTTP endpoint bound to localhost. The socket work runs on a
+// private thread; responses are serialized once in publish() and swapped
+// in atomically, so serving a request never touches the caller's state.
+class StatsServer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit StatsServer(QObject *parent = nullptr);
+    ~StatsServer() override;
+    
+    // Starts listening on 127.0.0.1:port, returns false if the port is unavailable
+    bool start(quint16 port);
+    quint16 port() const;
+    
+    // Connections still open after msec are aborted; applies to new connections
+    void setIdleTimeout(int msec);
+    
+    // Replaces the JSON served at / and /stats; safe to call from any thread
+    void publish(const QByteArray& json);
+
+private:
+    void acceptConnections();
+    void handleRequest(QTcpSocket *socket);
+    static QByteArray buildResponse(const QByteArray& status, const QByteArray& body);
+    
+    QThread m_thread;
+    QTcpServer *m_tcp_server;
+    quint16 m_port;
+    std::atomic<int> m_idle_timeout_ms;
+    std::shared_ptr<const QByteArray> m_stats_response;
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Fixed-capacity text builder for the UI refresh path. Numbers are written
+// like a default std::ostream (%g, precision 6) regardless of the C locale,
+// which QApplication switches to the user's. Output that does not fit is
+// truncated; nothing here allocates. Doubles use std::to_chars where the
+// standard library has it (GCC 11+) and snprintf otherwise.
+class TextBuffer {
+public:
+    TextBuffer() = default;
+    
+    TextBuffer& operator<<(const char *text);
+    TextBuffer& operator<<(const std::string& text);
+    TextBuffer& operator<<(double value);
+    TextBuffer& operator<<(int value);
+    TextBuffer& operator<<(std::size_t value);
+    
+    // Significant digits for doubles, like std::setprecision
+    void set_precision(int precision) { m_precision = precision; }
+    
+    // Appends text padded with spaces to at least width characters
+    void append_left(const char *text, std::size_t length, std::size_t width);
+    void append_right(const char *text, std::size_t length, std::size_t width);
+    
+    void clear() { m_size = 0; m_data[0] = '\0'; }
+    const char *c_str() const { return m_data; }
+    std::size_t size() const { return m_size; }
+
+private:
+    void append(const char *text, std::size_t length);
+    void append_spaces(std::size_t count);
+    
+    static const std::size_t CAPACITY = 256;
+    
+    char m_data[CAPACITY] = {};
+    std::size_t m_size = 0;
+    int m_precision = 6;
+};
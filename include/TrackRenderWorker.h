@@ -0,0 +1,47 @@
+#pragma once
+
+#include "TrackWidget.h"
+#include <QObject>
+#include <QImage>
+#include <QSize>
+#include <QMutex>
+#include <atomic>
+
+// Lives on TrackWidget's render thread and draws scenes into images.
+// Requests that are superseded before or during rendering are discarded.
+// Frames are drawn into two reused images.
+class TrackRenderWorker : public QObject {
+    Q_OBJECT
+
+public:
+    explicit TrackRenderWorker(QObject *parent = nullptr);
+    
+    // Called from the GUI thread. Requests arriving before the render thread
+    // picks up the previous one replace it, so a burst queues a single call.
+    void submit(const TrackScene& scene, quint64 generation);
+
+signals:
+    void frameReady(const QImage& frame, quint64 generation);
+
+private slots:
+    void renderPending();
+
+private:
+    bool isStale(quint64 generation) const;
+    QImage& acquireBuffer(const QSize& size, qreal devicePixelRatio);
+    void render(const TrackScene& scene, quint64 generation);
+    
+    // Latest request, handed over under the mutex instead of through the event queue
+    QMutex m_pending_mutex;
+    TrackScene m_pending_scene;
+    quint64 m_pending_generation;
+    bool m_render_queued;
+    
+    // Render thread's copy of the scene being drawn, reused between frames
+    TrackScene m_scene;
+    
+    // Double buffer: the widget shows one image while the other is drawn
+    QImage m_buffers[2];
+    int m_next_buffer;
+    std::atomic<quint64> m_latest_generation;
+};
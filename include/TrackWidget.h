@@ -3,32 +3,91 @@
 #include <QWidget>
 #include <QPainter>
 #include <QPainterPath>
+#include <QImage>
+#include <QString>
+#include <QThread>
+#include <QTimer>
 #include <cmath>
 
+class TrackRenderWorker;
+
+// Everything needed to draw one frame, captured on the GUI thread
+struct TrackScene {
+    int width = 0;
+    int height = 0;
+    qreal devicePixelRatio = 1.0;
+    double currentKm = 0.0;
+    double totalKm = 0.0;
+    double progressPercent = 0.0;
+    int dayOfYear = 1;
+    
+    // Preformatted by the widget so rendering does not build strings
+    QString progressText;
+    QString kmText;
+    QString widthText;
+    QString heightText;
+};
+
 class TrackWidget : public QWidget {
     Q_OBJECT
 
 public:
     explicit TrackWidget(QWidget *parent = nullptr);
+    ~TrackWidget() override;
     
     void setProgress(double current, double total);
     
+    // When enabled, frames are drawn on a worker thread and only blitted here.
+    // On by default where fonts can be rendered outside the GUI thread.
+    void setThreadedRendering(bool enabled);
+    bool threadedRendering() const { return m_threaded_rendering; }
+    
     QSize sizeHint() const override;
     QSize minimumSizeHint() const override;
+    
+    // Draws the whole track; safe to call from any thread
+    static void renderScene(QPainter& painter, const TrackScene& scene);
 
 protected:
     void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private slots:
+    void onFrameReady(const QImage& frame, quint64 generation);
+    void onDateChanged();
 
 private:
-    QPointF getPositionOnTrack(double percent, int centerX, int centerY, 
-                               int trackWidth, int trackHeight, int trackThickness, bool outer);
-    double calculateTrackPerimeter(int trackWidth, int trackHeight) const;
-    void drawProgressMarker(QPainter& painter, double percent, int centerX, int centerY,
-                           int trackWidth, int trackHeight, int trackThickness,
-                           const QColor& color);
+    static QPointF getPositionOnTrack(double percent, int centerX, int centerY, 
+                                      int trackWidth, int trackHeight, int trackThickness, bool outer);
+    static double calculateTrackPerimeter(int trackWidth, int trackHeight);
+    static void trackDimensions(int width, int height, int& trackWidth, int& trackHeight);
+    static void drawProgressMarker(QPainter& painter, double percent, int centerX, int centerY,
+                                   int trackWidth, int trackHeight, int trackThickness,
+                                   const QColor& color);
     int get_day_of_year() const;
+    TrackScene currentScene() const;
+    void requestFrame();
+    void armMidnightTimer();
+    void updateProgressText();
+    void updateDimensionText();
     
     double m_current_km;
     double m_total_km;
     double m_progress_percent;
+    
+    // Cached text, rebuilt only when progress or size changes
+    QString m_progress_text;
+    QString m_km_text;
+    QString m_width_text;
+    QString m_height_text;
+    
+    // Fires just after midnight so the pacer marker moves to the new day
+    QTimer m_midnight_timer;
+    
+    // Threaded rendering: newest generation wins, older frames are dropped
+    bool m_threaded_rendering;
+    quint64 m_generation;
+    QImage m_frame;
+    QThread m_render_thread;
+    TrackRenderWorker *m_render_worker;
 };
@@ -0,0 +1,290 @@
+#include "CumulativeChartWidget.h"
+#include "Lttb.h"
+#include <QPen>
+#include <QFont>
+#include <QDate>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const int MAX_ZOOM_LEVEL = 16;
+const int POINTS_PER_PIXEL = 2;
+// Cached levels are built for the plot width rounded up to a power of two,
+// so resizing only rebuilds them when a power of two is crossed
+const int MIN_CACHE_WIDTH = 256;
+
+bool lessByX(const QPointF& point, double x) {
+    return point.x() < x;
+}
+
+QPointF wheelPosition(const QWheelEvent *event) {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    return event->position();
+#else
+    return event->posF();
+#endif
+}
+
+}  // namespace
+
+CumulativeChartWidget::CumulativeChartWidget(QWidget *parent)
+    : QWidget(parent),
+      m_pacer_origin(0.0),
+      m_pacer_km_per_day(0.0),
+      m_zoom_level(0),
+      m_view_start(0.0),
+      m_drag_last_x(0.0),
+      m_cache_width(0),
+      m_start_label_day(-1),
+      m_end_label_day(-1),
+      m_y_min_label_km(0),
+      m_y_max_label_km(0)
+{
+    setMinimumSize(400, 150);
+}
+
+void CumulativeChartWidget::setSeries(QVector<QPointF> points, double pacerOriginDay,
+                                      double pacerKmPerDay) {
+    bool hadPoints = !m_points.isEmpty();
+    m_points = std::move(points);
+    m_pacer_origin = pacerOriginDay;
+    m_pacer_km_per_day = pacerKmPerDay;
+    m_lod_cache.clear();
+    
+    // Keep the user's zoom and pan unless there was nothing to look at before
+    if (!hadPoints || m_points.isEmpty()) {
+        m_zoom_level = 0;
+        m_view_start = m_points.isEmpty() ? 0.0 : m_points.first().x();
+    }
+    while (m_zoom_level > 0 && std::ldexp(fullSpan(), -m_zoom_level) < 1.0) {
+        --m_zoom_level;
+    }
+    clampViewStart();
+    update();
+}
+
+bool CumulativeChartWidget::appendPoint(const QPointF& point) {
+    if (m_points.isEmpty() || point.x() < m_points.last().x()) {
+        return false;
+    }
+    
+    m_points.append(point);
+    // LTTB always keeps the last point, so appending to each level keeps its
+    // shape; a level is rebuilt once it has grown well past its threshold
+    for (auto it = m_lod_cache.begin(); it != m_lod_cache.end(); ++it) {
+        it.value().append(point);
+    }
+    update();
+    return true;
+}
+
+QSize CumulativeChartWidget::sizeHint() const {
+    return QSize(800, 200);
+}
+
+QSize CumulativeChartWidget::minimumSizeHint() const {
+    return QSize(400, 150);
+}
+
+QRectF CumulativeChartWidget::plotRect() const {
+    return QRectF(60, 10, std::max(1, width() - 70), std::max(1, height() - 35));
+}
+
+double CumulativeChartWidget::fullSpan() const {
+    if (m_points.isEmpty()) {
+        return 1.0;
+    }
+    return std::max(m_points.last().x() - m_points.first().x(), 1.0);
+}
+
+double CumulativeChartWidget::visibleSpan() const {
+    return std::ldexp(fullSpan(), -m_zoom_level);
+}
+
+void CumulativeChartWidget::clampViewStart() {
+    if (m_points.isEmpty()) {
+        return;
+    }
+    double first = m_points.first().x();
+    double last = first + fullSpan();
+    m_view_start = std::max(first, std::min(m_view_start, last - visibleSpan()));
+}
+
+double CumulativeChartWidget::pacerKmAt(double day) const {
+    return (day - m_pacer_origin + 1) * m_pacer_km_per_day;
+}
+
+const QVector<QPointF>& CumulativeChartWidget::pointsForZoomLevel(int level) {
+    int plotWidth = static_cast<int>(plotRect().width());
+    int cacheWidth = std::max(MIN_CACHE_WIDTH, static_cast<int>(qNextPowerOfTwo(quint32(plotWidth - 1))));
+    if (cacheWidth != m_cache_width) {
+        m_lod_cache.clear();
+        m_cache_width = cacheWidth;
+    }
+    
+    // Every level doubles the resolution so the visible slice stays ~cacheWidth buckets
+    qint64 threshold = static_cast<qint64>(cacheWidth) * POINTS_PER_PIXEL << level;
+    if (threshold >= m_points.size()) {
+        return m_points;
+    }
+    
+    auto it = m_lod_cache.find(level);
+    if (it != m_lod_cache.end() && it.value().size() > threshold + threshold / 4) {
+        m_lod_cache.erase(it);
+        it = m_lod_cache.end();
+    }
+    if (it == m_lod_cache.end()) {
+        it = m_lod_cache.insert(level, lttb_downsample(m_points, static_cast<int>(threshold)));
+    }
+    return it.value();
+}
+
+void CumulativeChartWidget::paintEvent(QPaintEvent *event) {
+    Q_UNUSED(event);
+    
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    
+    QRectF rect = plotRect();
+    QFont font = painter.font();
+    font.setPointSize(9);
+    font.setFamily(QStringLiteral("Monospace"));
+    painter.setFont(font);
+    
+    // Plot frame
+    painter.setPen(QPen(QColor(85, 85, 85), 1));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRect(rect);
+    
+    if (m_points.isEmpty()) {
+        painter.setPen(QColor(120, 120, 120));
+        painter.drawText(rect, Qt::AlignCenter, QStringLiteral("No entries yet"));
+        return;
+    }
+    
+    double viewStart = m_view_start;
+    double span = visibleSpan();
+    double viewEnd = viewStart + span;
+    
+    // Slice the visible range, keeping one point on each side so the line reaches the edges
+    const QVector<QPointF>& points = pointsForZoomLevel(m_zoom_level);
+    auto begin = std::lower_bound(points.constBegin(), points.constEnd(), viewStart, lessByX);
+    auto end = std::lower_bound(begin, points.constEnd(), viewEnd, lessByX);
+    if (begin != points.constBegin()) --begin;
+    if (end != points.constEnd()) ++end;
+    int count = static_cast<int>(end - begin);
+    
+    // Cumulative distance only grows, so the slice ends bound the Y range
+    double yMin = std::min(begin->y(), pacerKmAt(viewStart));
+    double yMax = std::max((end - 1)->y(), pacerKmAt(viewEnd));
+    if (m_zoom_level == 0) yMin = std::min(yMin, 0.0);
+    if (yMax - yMin < 1.0) yMax = yMin + 1.0;
+    
+    double xScale = rect.width() / span;
+    double yScale = rect.height() / (yMax - yMin);
+    
+    painter.save();
+    painter.setClipRect(rect);
+    
+    // Ideal pacer line (cyan, matches the track marker)
+    painter.setPen(QPen(QColor(0, 255, 255), 1));
+    painter.drawLine(QPointF(rect.left(), rect.bottom() - (pacerKmAt(viewStart) - yMin) * yScale),
+                     QPointF(rect.right(), rect.bottom() - (pacerKmAt(viewEnd) - yMin) * yScale));
+    
+    // Cumulative distance as one batched polyline (red, matches the track marker)
+    m_screen_points.resize(count);
+    QPointF *screen = m_screen_points.data();
+    for (int i = 0; i < count; ++i) {
+        const QPointF& point = begin[i];
+        screen[i] = QPointF(rect.left() + (point.x() - viewStart) * xScale,
+                            rect.bottom() - (point.y() - yMin) * yScale);
+    }
+    painter.setPen(QPen(QColor(220, 50, 50), 2));
+    painter.drawPolyline(screen, count);
+    
+    painter.restore();
+    
+    // Axis labels
+    updateAxisLabels(viewStart, viewEnd, yMin, yMax);
+    painter.setPen(QColor(120, 120, 120));
+    painter.drawText(QRectF(rect.left(), rect.bottom() + 3, 100, 18), Qt::AlignLeft, m_start_label);
+    painter.drawText(QRectF(rect.right() - 100, rect.bottom() + 3, 100, 18), Qt::AlignRight, m_end_label);
+    painter.drawText(QRectF(0, rect.top(), rect.left() - 5, 18), Qt::AlignRight, m_y_max_label);
+    painter.drawText(QRectF(0, rect.bottom() - 18, rect.left() - 5, 18), Qt::AlignRight, m_y_min_label);
+}
+
+void CumulativeChartWidget::updateAxisLabels(double viewStart, double viewEnd, double yMin, double yMax) {
+    // Labels are rebuilt only when the rounded value they show changes
+    qint64 startDay = static_cast<qint64>(viewStart);
+    qint64 endDay = static_cast<qint64>(viewEnd);
+    qint64 yMinKm = qRound64(yMin);
+    qint64 yMaxKm = qRound64(yMax);
+    
+    if (startDay != m_start_label_day) {
+        m_start_label_day = startDay;
+        m_start_label = QDate::fromJulianDay(startDay).toString(QStringLiteral("yyyy-MM-dd"));
+    }
+    if (endDay != m_end_label_day) {
+        m_end_label_day = endDay;
+        m_end_label = QDate::fromJulianDay(endDay).toString(QStringLiteral("yyyy-MM-dd"));
+    }
+    if (yMinKm != m_y_min_label_km || m_y_min_label.isEmpty()) {
+        m_y_min_label_km = yMinKm;
+        m_y_min_label = QString::number(yMinKm) + QLatin1String(" km");
+    }
+    if (yMaxKm != m_y_max_label_km || m_y_max_label.isEmpty()) {
+        m_y_max_label_km = yMaxKm;
+        m_y_max_label = QString::number(yMaxKm) + QLatin1String(" km");
+    }
+}
+
+void CumulativeChartWidget::wheelEvent(QWheelEvent *event) {
+    if (m_points.isEmpty()) {
+        return;
+    }
+    
+    int level = m_zoom_level + (event->angleDelta().y() > 0 ? 1 : -1);
+    // Stop zooming in once a single day fills the view
+    if (level < 0 || level > MAX_ZOOM_LEVEL || std::ldexp(fullSpan(), -level) < 1.0) {
+        return;
+    }
+    
+    // Keep the day under the cursor in place
+    QRectF rect = plotRect();
+    double fraction = std::max(0.0, std::min(1.0, (wheelPosition(event).x() - rect.left()) / rect.width()));
+    double anchor = m_view_start + fraction * visibleSpan();
+    m_zoom_level = level;
+    m_view_start = anchor - fraction * visibleSpan();
+    clampViewStart();
+    
+    event->accept();
+    update();
+}
+
+void CumulativeChartWidget::mousePressEvent(QMouseEvent *event) {
+    m_drag_last_x = event->localPos().x();
+}
+
+void CumulativeChartWidget::mouseMoveEvent(QMouseEvent *event) {
+    if (!(event->buttons() & Qt::LeftButton) || m_zoom_level == 0) {
+        return;
+    }
+    
+    double x = event->localPos().x();
+    m_view_start -= (x - m_drag_last_x) / plotRect().width() * visibleSpan();
+    m_drag_last_x = x;
+    clampViewStart();
+    update();
+}
+
+void CumulativeChartWidget::mouseDoubleClickEvent(QMouseEvent *event) {
+    Q_UNUSED(event);
+    
+    m_zoom_level = 0;
+    m_view_start = m_points.isEmpty() ? 0.0 : m_points.first().x();
+    update();
+}
@@ -0,0 +1,62 @@
+#include "DataFile.h"
+#include <QFile>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// need to use this because std::stod breaks with qt app
+double my_stod(const std::string &valueAsString) {
+    std::istringstream totalSString( valueAsString );
+    double valueAsDouble;
+    // maybe use some manipulators
+    totalSString >> valueAsDouble;
+    if(!totalSString)
+        throw std::runtime_error("Error converting to double");    
+    return valueAsDouble;
+}
+
+}  // namespace
+
+DataFileContents read_data_file(const QString& path) {
+    DataFileContents data;
+    data.stamp = stat_data_file(path);
+    
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        // File doesn't exist yet, which is fine for first run
+        data.stamp = DataFileStamp();
+        return data;
+    }
+    
+    QByteArray contents = file.readAll();
+    file.close();
+    data.stamp.size = contents.size();
+    data.stamp.hash = hash_data_file_contents(contents);
+    
+    std::istringstream stream(contents.toStdString());
+    std::string line;
+    
+    while (std::getline(stream, line)) {
+        if (line.empty()) continue;
+        
+        size_t comma_pos = line.find(',');
+        if (comma_pos == std::string::npos) continue;
+        
+        std::string date = line.substr(0, comma_pos);
+        std::string km_str = line.substr(comma_pos + 1);
+
+        float kilometers;
+        try {
+            kilometers = my_stod(km_str);
+        } catch (const std::exception&) {
+            // Skip invalid lines
+            continue;
+        }
+        // The add and import paths never write these; drop hand-edited ones too
+        if (!(kilometers > 0)) continue;
+        data.entries.emplace_back(date, kilometers);
+    }
+    
+    return data;
+}
@@ -0,0 +1,476 @@
+#include "ImportDialog.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QFileDialog>
+#include <QFile>
+#include <QTextStream>
+#include <QMessageBox>
+#include <QDate>
+#include <QVector>
+#include <QtConcurrent/QtConcurrentMap>
+#include <algorithm>
+
+namespace {
+
+const double KM_PER_MILE = 1.609344;
+
+enum ColumnLayout {
+    LayoutAuto = 0,
+    LayoutDateDistance,
+    LayoutDistanceDate
+};
+
+struct ImportOptions {
+    QChar delimiter;
+    int date_column;
+    int distance_column;
+    QString date_format;
+    double km_factor;
+};
+
+struct ImportLine {
+    int line_number;
+    QString text;
+};
+
+struct ImportRow {
+    int line_number = 0;
+    QString date;
+    double kilometers = 0.0;
+    QString error;
+};
+
+// Picks the delimiter that occurs most often in the first row
+QChar detect_delimiter(const QString& line) {
+    const QChar candidates[] = { '\t', ';', ',' };
+    QChar best = ',';
+    int best_count = 0;
+    for (QChar candidate : candidates) {
+        int count = line.count(candidate);
+        if (count > best_count) {
+            best = candidate;
+            best_count = count;
+        }
+    }
+    return best;
+}
+
+// Splits one CSV row, honouring double-quoted fields with "" escapes
+QStringList split_fields(const QString& line, QChar delimiter) {
+    QStringList fields;
+    QString field;
+    bool quoted = false;
+    
+    for (int i = 0; i < line.size(); ++i) {
+        QChar c = line[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                field += '"';
+                ++i;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                field += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == delimiter) {
+            fields.append(field.trimmed());
+            field.clear();
+        } else {
+            field += c;
+        }
+    }
+    fields.append(field.trimmed());
+    return fields;
+}
+
+// Names are in priority order. Exact or prefix matches win over substrings, so
+// "Distance (km)" is preferred to an earlier "Avg Pace (min/km)".
+int find_column(const QStringList& header, const QStringList& names) {
+    for (const QString& name : names) {
+        for (int i = 0; i < header.size(); ++i) {
+            if (header[i].trimmed().toLower().startsWith(name)) {
+                return i;
+            }
+        }
+    }
+    for (const QString& name : names) {
+        for (int i = 0; i < header.size(); ++i) {
+            if (header[i].toLower().contains(name)) {
+                return i;
+            }
+        }
+    }
+    return -1;
+}
+
+QDate parse_date(const QString& text, const QString& format) {
+    QDate date = QDate::fromString(text, format);
+    if (!date.isValid()) {
+        // Exports often append a time of day, e.g. "2024-01-05 07:12:00"
+        int time_start = text.indexOf(' ');
+        if (time_start < 0) time_start = text.indexOf('T');
+        if (time_start > 0) {
+            date = QDate::fromString(text.left(time_start), format);
+        }
+    }
+    return date;
+}
+
+enum DistanceResult {
+    DistanceOk = 0,
+    DistanceInvalid,
+    DistanceAmbiguous,
+    DistanceUnknownUnit
+};
+
+// Factor to kilometres for a unit suffix, 0 if the suffix is not a known unit
+double unit_factor(const QString& unit) {
+    static const char *const kilometres[] = { "km", "kms", "k", "kilometer", "kilometers",
+                                              "kilometre", "kilometres" };
+    static const char *const miles[] = { "mi", "mile", "miles" };
+    for (const char *name : kilometres) {
+        if (unit == QLatin1String(name)) return 1.0;
+    }
+    for (const char *name : miles) {
+        if (unit == QLatin1String(name)) return KM_PER_MILE;
+    }
+    return 0.0;
+}
+
+// True if digits are grouped in threes by separator, as in "1,234,567"
+bool has_thousands_groups(const QString& integer_part, QChar separator) {
+    QStringList groups = integer_part.split(separator);
+    for (int i = 0; i < groups.size(); ++i) {
+        int size = groups[i].size();
+        if (i == 0 ? (size < 1 || size > 3) : size != 3) return false;
+    }
+    return true;
+}
+
+// Parses a distance in kilometres. A unit suffix such as "km" or "mi" wins
+// over default_factor, which applies to bare numbers.
+DistanceResult parse_distance(QString text, QChar delimiter, double default_factor, double& km) {
+    text = text.trimmed();
+    int unit_start = text.size();
+    while (unit_start > 0 && text[unit_start - 1].isLetter()) {
+        --unit_start;
+    }
+    double factor = default_factor;
+    if (unit_start == 0) {
+        return DistanceInvalid;
+    }
+    if (unit_start < text.size()) {
+        factor = unit_factor(text.mid(unit_start).toLower());
+        if (factor == 0.0) {
+            return DistanceUnknownUnit;
+        }
+        text = text.left(unit_start).trimmed();
+    }
+    
+    int comma = text.lastIndexOf(',');
+    int point = text.lastIndexOf('.');
+    if (comma >= 0 && point >= 0) {
+        // Whichever separator comes last is the decimal mark: "1,234.5" or "1.234,5"
+        QChar decimal = comma > point ? QChar(',') : QChar('.');
+        QChar thousands = comma > point ? QChar('.') : QChar(',');
+        int decimal_at = std::max(comma, point);
+        if (text.count(decimal) != 1 || !has_thousands_groups(text.left(decimal_at), thousands)) {
+            return DistanceAmbiguous;
+        }
+        text.remove(thousands);
+        text.replace(decimal, '.');
+    } else if (comma >= 0) {
+        // "5,3" is a decimal comma, but "1,234" could be either; never guess
+        int digits_after = text.size() - comma - 1;
+        bool decimal_comma = delimiter != ',' && text.count(',') == 1 &&
+                             (digits_after == 1 || digits_after == 2);
+        if (!decimal_comma) {
+            return DistanceAmbiguous;
+        }
+        text[comma] = '.';
+    }
+    
+    bool ok;
+    double value = text.toDouble(&ok);
+    if (!ok) {
+        return DistanceInvalid;
+    }
+    km = value * factor;
+    return DistanceOk;
+}
+
+// Validates a single row; runs on the QtConcurrent pool
+struct RowValidator {
+    typedef ImportRow result_type;
+    
+    ImportOptions options;
+    
+    explicit RowValidator(const ImportOptions& o) : options(o) {}
+    
+    ImportRow operator()(const ImportLine& line) const {
+        ImportRow row;
+        row.line_number = line.line_number;
+        
+        QStringList fields = split_fields(line.text, options.delimiter);
+        if (fields.size() <= std::max(options.date_column, options.distance_column)) {
+            row.error = QString("Expected at least %1 columns, found %2")
+                            .arg(std::max(options.date_column, options.distance_column) + 1)
+                            .arg(fields.size());
+            return row;
+        }
+        
+        const QString& date_text = fields[options.date_column];
+        QDate date = parse_date(date_text, options.date_format);
+        if (!date.isValid()) {
+            row.error = "Invalid date \"" + date_text + "\" for format " + options.date_format;
+            return row;
+        }
+        row.date = date.toString("yyyy-MM-dd");
+        
+        const QString& distance_text = fields[options.distance_column];
+        double kilometers;
+        DistanceResult result = parse_distance(distance_text, options.delimiter,
+                                               options.km_factor, kilometers);
+        if (result == DistanceAmbiguous) {
+            row.error = "Ambiguous distance \"" + distance_text + "\", use a decimal point";
+            return row;
+        }
+        if (result == DistanceUnknownUnit) {
+            row.error = "Unknown unit in \"" + distance_text + "\", expected km or mi";
+            return row;
+        }
+        if (result != DistanceOk) {
+            row.error = "Invalid distance \"" + distance_text + "\"";
+            return row;
+        }
+        if (kilometers <= 0) {
+            row.error = "Distance must be positive";
+            return row;
+        }
+        row.kilometers = kilometers;
+        
+        return row;
+    }
+};
+
+}  // namespace
+
+ImportDialog::ImportDialog(QWidget *parent)
+    : QDialog(parent)
+{
+    setWindowTitle("Import Runs");
+    resize(750, 600);
+    
+    setup_ui();
+    on_layout_changed();
+}
+
+void ImportDialog::setup_ui() {
+    QVBoxLayout *main_layout = new QVBoxLayout(this);
+    main_layout->setSpacing(10);
+    
+    QLabel *input_label = new QLabel("Paste rows or open a CSV export:", this);
+    m_input_edit = new QPlainTextEdit(this);
+    m_input_edit->setPlaceholderText("Date,Distance\n2024-01-05,5.2\n2024-01-07,10.0");
+    m_input_edit->setLineWrapMode(QPlainTextEdit::NoWrap);
+    
+    // Format options
+    QHBoxLayout *options_layout = new QHBoxLayout();
+    options_layout->setSpacing(5);
+    
+    m_layout_combo = new QComboBox(this);
+    m_layout_combo->addItem("Auto (from header)", LayoutAuto);
+    m_layout_combo->addItem("Date, Distance", LayoutDateDistance);
+    m_layout_combo->addItem("Distance, Date", LayoutDistanceDate);
+    
+    m_header_check = new QCheckBox("Header row", this);
+    m_header_check->setChecked(true);
+    
+    m_date_format_combo = new QComboBox(this);
+    m_date_format_combo->setEditable(true);
+    m_date_format_combo->addItems({ "yyyy-MM-dd", "dd.MM.yyyy", "dd/MM/yyyy", "MM/dd/yyyy", "d MMM yyyy" });
+    
+    m_unit_combo = new QComboBox(this);
+    m_unit_combo->addItem("km", 1.0);
+    m_unit_combo->addItem("miles", KM_PER_MILE);
+    
+    m_open_button = new QPushButton("Open File...", this);
+    m_validate_button = new QPushButton("Validate", this);
+    
+    options_layout->addWidget(new QLabel("Columns:", this));
+    options_layout->addWidget(m_layout_combo);
+    options_layout->addWidget(m_header_check);
+    options_layout->addWidget(new QLabel("Date format:", this));
+    options_layout->addWidget(m_date_format_combo);
+    options_layout->addWidget(new QLabel("Unit:", this));
+    options_layout->addWidget(m_unit_combo);
+    options_layout->addStretch();
+    options_layout->addWidget(m_open_button);
+    options_layout->addWidget(m_validate_button);
+    
+    // Validation results
+    m_results_table = new QTableWidget(0, 4, this);
+    m_results_table->setHorizontalHeaderLabels({ "Line", "Date", "Kilometers", "Status" });
+    m_results_table->horizontalHeader()->setStretchLastSection(true);
+    m_results_table->verticalHeader()->setVisible(false);
+    m_results_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    
+    m_summary_label = new QLabel(this);
+    
+    m_button_box = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    m_button_box->button(QDialogButtonBox::Ok)->setText("Import");
+    m_button_box->button(QDialogButtonBox::Ok)->setEnabled(false);
+    
+    main_layout->addWidget(input_label);
+    main_layout->addWidget(m_input_edit, 1);
+    main_layout->addLayout(options_layout);
+    main_layout->addWidget(m_results_table, 1);
+    main_layout->addWidget(m_summary_label);
+    main_layout->addWidget(m_button_box);
+    
+    // Connect signals
+    connect(m_open_button, &QPushButton::clicked, this, &ImportDialog::on_open_file_clicked);
+    connect(m_validate_button, &QPushButton::clicked, this, &ImportDialog::on_validate_clicked);
+    connect(m_input_edit, &QPlainTextEdit::textChanged, this, &ImportDialog::on_input_changed);
+    connect(m_layout_combo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &ImportDialog::on_layout_changed);
+    connect(m_header_check, &QCheckBox::toggled, this, &ImportDialog::on_input_changed);
+    connect(m_date_format_combo, &QComboBox::currentTextChanged, this, &ImportDialog::on_input_changed);
+    connect(m_unit_combo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &ImportDialog::on_input_changed);
+    connect(m_button_box, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(m_button_box, &QDialogButtonBox::rejected, this, &QDialog::reject);
+}
+
+const std::vector<RunningEntry>& ImportDialog::accepted_entries() const {
+    return m_accepted;
+}
+
+void ImportDialog::on_open_file_clicked() {
+    QString path = QFileDialog::getOpenFileName(this, "Open CSV Export", QString(),
+                                                "CSV files (*.csv *.txt);;All files (*)");
+    if (path.isEmpty()) {
+        return;
+    }
+    
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QMessageBox::warning(this, "Warning", "Could not open file:\n" + path);
+        return;
+    }
+    
+    QTextStream stream(&file);
+    m_input_edit->setPlainText(stream.readAll());
+    on_validate_clicked();
+}
+
+void ImportDialog::on_input_changed() {
+    // Anything validated before no longer matches the input
+    m_accepted.clear();
+    m_button_box->button(QDialogButtonBox::Ok)->setEnabled(false);
+    show_summary("Press Validate to check the rows.");
+}
+
+void ImportDialog::on_layout_changed() {
+    // Auto-detection needs the header to find the columns
+    bool auto_layout = m_layout_combo->currentData().toInt() == LayoutAuto;
+    if (auto_layout) {
+        m_header_check->setChecked(true);
+    }
+    m_header_check->setEnabled(!auto_layout);
+    on_input_changed();
+}
+
+void ImportDialog::show_summary(const QString& text) {
+    m_summary_label->setText(text);
+}
+
+void ImportDialog::on_validate_clicked() {
+    on_input_changed();
+    m_results_table->setRowCount(0);
+    
+    QStringList lines = m_input_edit->toPlainText().split('\n');
+    
+    QVector<ImportLine> inputs;
+    inputs.reserve(lines.size());
+    for (int i = 0; i < lines.size(); ++i) {
+        QString line = lines[i].trimmed();
+        if (!line.isEmpty()) {
+            inputs.append({ i + 1, line });
+        }
+    }
+    
+    if (inputs.isEmpty()) {
+        show_summary("Nothing to import.");
+        return;
+    }
+    
+    ImportOptions options;
+    options.delimiter = detect_delimiter(inputs.first().text);
+    options.date_column = 0;
+    options.distance_column = 1;
+    options.date_format = m_date_format_combo->currentText();
+    options.km_factor = m_unit_combo->currentData().toDouble();
+    
+    int layout = m_layout_combo->currentData().toInt();
+    if (layout == LayoutDistanceDate) {
+        options.date_column = 1;
+        options.distance_column = 0;
+    }
+    
+    if (m_header_check->isChecked()) {
+        QStringList header = split_fields(inputs.first().text, options.delimiter);
+        inputs.removeFirst();
+        
+        if (layout == LayoutAuto) {
+            options.date_column = find_column(header, { "date" });
+            options.distance_column = find_column(header, { "distance", "km", "kilomet", "mile" });
+            if (options.date_column < 0 || options.distance_column < 0) {
+                show_summary("Could not find date and distance columns in the header. "
+                             "Pick a column layout instead.");
+                return;
+            }
+        }
+    }
+    
+    // Validate every row in parallel, results keep the input order
+    QVector<ImportRow> rows = QtConcurrent::blockingMapped<QVector<ImportRow>>(inputs, RowValidator(options));
+    
+    int error_count = 0;
+    m_results_table->setUpdatesEnabled(false);
+    m_results_table->setRowCount(rows.size());
+    for (int i = 0; i < rows.size(); ++i) {
+        const ImportRow& row = rows[i];
+        bool valid = row.error.isEmpty();
+        
+        m_results_table->setItem(i, 0, new QTableWidgetItem(QString::number(row.line_number)));
+        m_results_table->setItem(i, 1, new QTableWidgetItem(row.date));
+        m_results_table->setItem(i, 2, new QTableWidgetItem(valid ? QString::number(row.kilometers, 'f', 2) : QString()));
+        QTableWidgetItem *status = new QTableWidgetItem(valid ? "OK" : row.error);
+        status->setForeground(valid ? QColor(0, 255, 136) : QColor(220, 50, 50));
+        m_results_table->setItem(i, 3, status);
+        
+        if (valid) {
+            m_accepted.emplace_back(row.date.toStdString(), row.kilometers);
+        } else {
+            ++error_count;
+        }
+    }
+    m_results_table->setUpdatesEnabled(true);
+    
+    // Dates are yyyy-MM-dd so string order is chronological
+    std::stable_sort(m_accepted.begin(), m_accepted.end(),
+                     [](const RunningEntry& a, const RunningEntry& b) {
+                         return a.date < b.date;
+                     });
+    
+    QString summary = QString("%1 rows ready to import").arg(m_accepted.size());
+    if (error_count > 0) {
+        summary += QString(", %1 rows with errors will be skipped").arg(error_count);
+    }
+    show_summary(summary + ".");
+    m_button_box->button(QDialogButtonBox::Ok)->setEnabled(!m_accepted.empty());
+}
@@ -0,0 +1,62 @@
+#include "Lttb.h"
+#include <algorithm>
+#include <cmath>
+
+QVector<QPointF> lttb_downsample(const QVector<QPointF>& points, int threshold) {
+    const int count = points.size();
+    if (threshold >= count || threshold < 3) {
+        return points;
+    }
+    
+    QVector<QPointF> sampled;
+    sampled.reserve(threshold);
+    
+    const QPointF* data = points.constData();
+    
+    // First and last points are always kept, the rest is split into buckets
+    const double bucketSize = static_cast<double>(count - 2) / (threshold - 2);
+    int selected = 0;
+    sampled.append(data[0]);
+    
+    for (int bucket = 0; bucket < threshold - 2; ++bucket) {
+        // Average of the next bucket is the third corner of the triangle
+        int avgStart = static_cast<int>(std::floor((bucket + 1) * bucketSize)) + 1;
+        int avgEnd = std::min(static_cast<int>(std::floor((bucket + 2) * bucketSize)) + 1, count);
+        avgStart = std::min(avgStart, avgEnd - 1);
+        
+        double avgX = 0.0;
+        double avgY = 0.0;
+        for (int i = avgStart; i < avgEnd; ++i) {
+            avgX += data[i].x();
+            avgY += data[i].y();
+        }
+        const int avgCount = avgEnd - avgStart;
+        avgX /= avgCount;
+        avgY /= avgCount;
+        
+        // Pick the point in the current bucket forming the largest triangle
+        const int rangeStart = static_cast<int>(std::floor(bucket * bucketSize)) + 1;
+        const int rangeEnd = std::min(static_cast<int>(std::floor((bucket + 1) * bucketSize)) + 1,
+                                      count - 1);
+        
+        const double ax = data[selected].x();
+        const double ay = data[selected].y();
+        double maxArea = -1.0;
+        int next = rangeStart;
+        
+        for (int i = rangeStart; i < rangeEnd; ++i) {
+            double area = std::fabs((ax - avgX) * (data[i].y() - ay) -
+                                    (ax - data[i].x()) * (avgY - ay));
+            if (area > maxArea) {
+                maxArea = area;
+                next = i;
+            }
+        }
+        
+        sampled.append(data[next]);
+        selected = next;
+    }
+    
+    sampled.append(data[count - 1]);
+    return sampled;
+}
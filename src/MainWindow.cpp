@@ -1,8 +1,10 @@
 #include "MainWindow.h"
-#include <iomanip>
-#include <sstream>
+#include "ImportDialog.h"
+#include "TextBuffer.h"
+#include "DataFile.h"
 #include <ctime>
 #include <numeric>
+#include <algorithm>
 #include <fstream>
 #include <locale>
 #include <QWidget>
@@ -10,21 +12,55 @@
 #include <QStandardPaths>
 #include <QDir>
 #include <QDate>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QFile>
+#include <QtConcurrent/QtConcurrentRun>
 #include <iostream>
 
-// need to use this because std::stod breaks with qt app
-double my_stod(const std::string &valueAsString) {
-    std::istringstream totalSString( valueAsString );
-    double valueAsDouble;
-    // maybe use some manipulators
-    totalSString >> valueAsDouble;
-    if(!totalSString)
-        throw std::runtime_error("Error converting to double");    
-    return valueAsDouble;
+static const double YEARLY_GOAL = 1000.0;
+
+// Value of the decimal digits in text[begin, end), or -1 if any is not a digit
+static int parse_digits(const std::string& text, size_t begin, size_t end) {
+    int value = 0;
+    for (size_t i = begin; i < end; ++i) {
+        if (text[i] < '0' || text[i] > '9') return -1;
+        value = value * 10 + (text[i] - '0');
+    }
+    return value;
+}
+
+// Parses exactly yyyy-MM-dd without building a QString; anything else is invalid
+static QDate parse_iso_date(const std::string& date) {
+    if (date.size() != 10 || date[4] != '-' || date[7] != '-') {
+        return QDate();
+    }
+    int year = parse_digits(date, 0, 4);
+    int month = parse_digits(date, 5, 7);
+    int day = parse_digits(date, 8, 10);
+    if (year < 0 || month < 0 || day < 0) {
+        return QDate();
+    }
+    return QDate(year, month, day);
+}
+
+// Replaces the label text only when the formatted value changed
+static void set_label_text(QLabel *label, std::string& shown, const TextBuffer& text) {
+    if (shown.size() == text.size() && shown.compare(text.c_str()) == 0) {
+        return;
+    }
+    shown.assign(text.c_str(), text.size());
+    label->setText(QString::fromLatin1(text.c_str(), static_cast<int>(text.size())));
 }
 
 MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent)
+    : QMainWindow(parent),
+      m_chart_valid(false),
+      m_chart_entry_count(0),
+      m_chart_total_km(0.0),
+      m_chart_last_day(-1),
+      m_stats_server(nullptr)
 {
     setWindowTitle("Running Tracker");
     resize(900, 600);
@@ -74,7 +110,7 @@ MainWindow::MainWindow(QWidget *parent)
         "    border: none; "
         "    background-color: #aaaa00; "
         "}"
-        "QTextEdit { "
+        "QTextEdit, QPlainTextEdit, QTableWidget { "
         "    background-color: #0a0a0a; "
         "    color: #555555; "
         "    border: 2px solid #aaaa00; "
@@ -92,10 +128,35 @@ MainWindow::MainWindow(QWidget *parent)
     QDir().mkpath(data_dir);
     m_data_file = data_dir + "/running_data.txt";
     
+    // Refresh buffers are sized once so steady-state updates reuse them
+    m_total_text.reserve(128);
+    m_count_text.reserve(128);
+    m_pacer_text.reserve(128);
+    m_goal_text.reserve(128);
+    m_list_text.reserve(2048);
+    m_list_scratch.reserve(2048);
+    
     setup_ui();
+    
+    connect(&m_load_watcher, &QFutureWatcher<DataFileContents>::finished,
+            this, &MainWindow::on_background_load_finished);
+    
+    // With a valid cache the numbers show up immediately and entries load lazily
+    RunningStats cached_stats;
+    if (load_cached_statistics(cached_stats)) {
+        show_statistics(cached_stats);
+        start_background_load();
+        return;
+    }
+    
     load_from_file();
+    compute_statistics(m_stats);
+    if (m_data_stamp.exists()) {
+        write_stats_cache(stats_cache_path(m_data_file), m_data_stamp, m_stats);
+    }
     update_list_view();
-    update_statistics();
+    show_statistics(m_stats);
+    update_chart();
 }
 
 void MainWindow::setup_ui() {
@@ -126,6 +187,7 @@ void MainWindow::setup_ui() {
     
     m_add_button = new QPushButton("Add Entry", this);
     m_remove_last_button = new QPushButton("Remove Last", this);
+    m_import_button = new QPushButton("Import...", this);
     
     input_layout->addWidget(date_label);
     input_layout->addWidget(m_date_edit);
@@ -133,24 +195,29 @@ void MainWindow::setup_ui() {
     input_layout->addWidget(m_kilometers_entry);
     input_layout->addWidget(m_add_button);
     input_layout->addWidget(m_remove_last_button);
+    input_layout->addWidget(m_import_button);
     input_layout->addStretch();  // Push everything to the left
     
     // Track visualization
     m_track_widget = new TrackWidget(this);
     
+    // Cumulative distance chart
+    m_chart_widget = new CumulativeChartWidget(this);
+    
     // Statistics section
     QVBoxLayout *stats_layout = new QVBoxLayout();
     stats_layout->setSpacing(5);
     
-    m_total_label = new QLabel("<b>Total: 0.0 km</b>", this);
-    m_count_label = new QLabel("<b>Entries: 0</b>", this);
-    m_daily_avg_label = new QLabel("<b>Daily Average: 0.0 km/day</b>", this);
-    m_goal_label = new QLabel("<b>Goal Progress: 0.0 / 1000 km (0%)</b>", this);
+    m_total_label = new QLabel("Total: 0.0 km", this);
+    m_count_label = new QLabel("Entries: 0", this);
+    m_daily_avg_label = new QLabel("Daily Average: 0.0 km/day", this);
+    m_goal_label = new QLabel("Goal Progress: 0.0 / 1000 km (0%)", this);
     
-    m_total_label->setTextFormat(Qt::RichText);
-    m_count_label->setTextFormat(Qt::RichText);
-    m_daily_avg_label->setTextFormat(Qt::RichText);
-    m_goal_label->setTextFormat(Qt::RichText);
+    // Plain text avoids re-parsing HTML on every refresh; QLabel is bold via the style sheet
+    m_total_label->setTextFormat(Qt::PlainText);
+    m_count_label->setTextFormat(Qt::PlainText);
+    m_daily_avg_label->setTextFormat(Qt::PlainText);
+    m_goal_label->setTextFormat(Qt::PlainText);
     
     stats_layout->addWidget(m_total_label);
     stats_layout->addWidget(m_count_label);
@@ -163,8 +230,8 @@ void MainWindow::setup_ui() {
     separator->setFrameShadow(QFrame::Sunken);
     
     // List header
-    QLabel *list_header = new QLabel("<b>Running History:</b>", this);
-    list_header->setTextFormat(Qt::RichText);
+    QLabel *list_header = new QLabel("Running History:", this);
+    list_header->setTextFormat(Qt::PlainText);
     
     // List view
     m_list_view = new QTextEdit(this);
@@ -199,12 +266,14 @@ void MainWindow::setup_ui() {
     main_layout->addLayout(input_layout);
     main_layout->addWidget(separator);
     main_layout->addLayout(content_layout);
+    main_layout->addWidget(m_chart_widget);
     
     setCentralWidget(central_widget);
     
     // Connect signals
     connect(m_add_button, &QPushButton::clicked, this, &MainWindow::on_add_button_clicked);
     connect(m_remove_last_button, &QPushButton::clicked, this, &MainWindow::on_remove_last_button_clicked);
+    connect(m_import_button, &QPushButton::clicked, this, &MainWindow::on_import_button_clicked);
     connect(m_kilometers_entry, &QLineEdit::returnPressed, this, &MainWindow::on_add_button_clicked);
 }
 
@@ -251,162 +320,407 @@ void MainWindow::on_remove_last_button_clicked() {
     
     // Remove the last entry
     m_entries.pop_back();
+    m_chart_valid = false;
     
     // Save and update UI
     save_and_update_ui();
 }
 
+void MainWindow::on_import_button_clicked() {
+    ImportDialog dialog(this);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+    
+    const std::vector<RunningEntry>& imported = dialog.accepted_entries();
+    if (imported.empty()) {
+        return;
+    }
+    
+    // Commit the whole batch with a single save and refresh
+    m_entries.reserve(m_entries.size() + imported.size());
+    m_entries.insert(m_entries.end(), imported.begin(), imported.end());
+    save_and_update_ui();
+}
+
 void MainWindow::update_list_view() {
-    std::ostringstream oss;
+    // Rows are formatted into reused buffers; the view is only reset when the text changed
+    std::string& text = m_list_scratch;
+    text.clear();
+    TextBuffer row;
     
     if (m_entries.empty()) {
-        oss << "No entries yet. Start tracking your runs!\n";
+        text += "No entries yet. Start tracking your runs!\n";
     } else {
-        oss << std::left << std::setw(15) << "Date" 
-            << std::right << std::setw(12) << "Kilometers\n";
-        oss << std::string(27, '-') << "\n";
+        row.append_left("Date", 4, 15);
+        row.append_right("Kilometers\n", 11, 12);
+        text += row.c_str();
+        text.append(27, '-');
+        text += "\n";
         
         // Display last 20 entries in reverse order (newest first)
-        
+        TextBuffer km;
         for (auto it = m_entries.rbegin(); it != m_entries.rend() && it != m_entries.rbegin() + 20; ++it) {
-            oss << std::left << std::setw(15) << it->date
-                << std::right << std::setw(10) 
-                << it->kilometers << " km\n";
+            km.clear();
+            km << it->kilometers;
+            row.clear();
+            row.append_left(it->date.data(), it->date.size(), 15);
+            row.append_right(km.c_str(), km.size(), 10);
+            row << " km\n";
+            text += row.c_str();
         }
         
         if (m_entries.size() > 20) {
-            oss << "\n... and " << (m_entries.size() - 20) << " more entries\n";
+            row.clear();
+            row << "\n... and " << (m_entries.size() - 20) << " more entries\n";
+            text += row.c_str();
         }
     }
     
-    m_list_view->setPlainText(QString::fromStdString(oss.str()));
+    if (text == m_list_text) {
+        return;
+    }
+    std::swap(m_list_text, m_list_scratch);
+    m_list_view->setPlainText(QString::fromStdString(m_list_text));
 }
 
-void MainWindow::update_statistics() {
-    const double YEARLY_GOAL = 1000.0;
-    const double REQUIRED_DAILY_AVG = YEARLY_GOAL / 365.0;
+void MainWindow::compute_statistics(RunningStats& stats) const {
+    // Reuse the month map nodes from the previous pass instead of rebuilding the map
+    for (auto& month : stats.monthly_km) {
+        month.second = 0.0;
+    }
+    stats.total = 0.0;
+    stats.days_tracked = 0;
+    stats.earliest.clear();
+    stats.latest.clear();
+    stats.entry_count = static_cast<int>(m_entries.size());
     
     if (m_entries.empty()) {
-        m_total_label->setText("<b>Total: 0.0 km</b>");
-        m_count_label->setText("<b>Entries: 0</b>");
-        
-        std::ostringstream daily_oss;
-        daily_oss << "<b>Daily Average: 0.0 km/day (Need: " 
-                   << REQUIRED_DAILY_AVG << " km/day)</b>";
-        m_daily_avg_label->setText(QString::fromStdString(daily_oss.str()));
-        m_goal_label->setText("<b>Goal Progress: 0.0 / 1000 km (0%)</b>");
+        stats.monthly_km.clear();
+        fill_derived_statistics(stats);
         return;
     }
     
-    double total = std::accumulate(m_entries.begin(), m_entries.end(), 0.0,
-                                   [](double sum, const RunningEntry& e) {
-                                       return sum + e.kilometers;
-                                   });
+    stats.total = std::accumulate(m_entries.begin(), m_entries.end(), 0.0,
+                                  [](double sum, const RunningEntry& e) {
+                                      return sum + e.kilometers;
+                                  });
+    
+    // Find earliest and latest dates, and roll up kilometres per month
+    stats.earliest = m_entries[0].date;
+    stats.latest = m_entries[0].date;
+    for (const auto& entry : m_entries) {
+        if (entry.date < stats.earliest) stats.earliest = entry.date;
+        if (entry.date > stats.latest) stats.latest = entry.date;
+        stats.monthly_km[entry.date.substr(0, 7)] += entry.kilometers;
+    }
+    
+    // Entries are positive (enforced on add, import and load), so an empty
+    // month means its entries were removed
+    for (auto it = stats.monthly_km.begin(); it != stats.monthly_km.end();) {
+        it = (it->second == 0.0) ? stats.monthly_km.erase(it) : std::next(it);
+    }
     
     // Calculate daily average based on date range
-    int days_tracked = 1;
+    stats.days_tracked = 1;
     if (m_entries.size() > 1) {
-        // Find earliest and latest dates
-        std::string earliest = m_entries[0].date;
-        std::string latest = m_entries[0].date;
-        
-        for (const auto& entry : m_entries) {
-            if (entry.date < earliest) earliest = entry.date;
-            if (entry.date > latest) latest = entry.date;
-        }
-        
-        // Parse dates and calculate difference
-        QDate start = QDate::fromString(QString::fromStdString(earliest), "yyyy-MM-dd");
-        QDate end = QDate::fromString(QString::fromStdString(latest), "yyyy-MM-dd");
-        days_tracked = start.daysTo(end) + 1;
+        QDate start = parse_iso_date(stats.earliest);
+        QDate end = parse_iso_date(stats.latest);
+        stats.days_tracked = start.daysTo(end) + 1;
     }
     
-    double daily_average = total / days_tracked;
-    double progress_percent = (total / YEARLY_GOAL) * 100.0;
-    int dayOfYear = get_day_of_year();
-    double pacer_km = (dayOfYear / 365.0) * 1000;
-    double pace_difference = daily_average - REQUIRED_DAILY_AVG;
+    fill_derived_statistics(stats);
+}
+
+void MainWindow::fill_derived_statistics(RunningStats& stats) const {
+    stats.daily_average = (stats.days_tracked > 0) ? stats.total / stats.days_tracked : 0.0;
+    stats.progress_percent = (stats.total / YEARLY_GOAL) * 100.0;
+    stats.pacer_km = (get_day_of_year() / 365.0) * YEARLY_GOAL;
+}
+
+void MainWindow::show_statistics(const RunningStats& stats) {
+    const double REQUIRED_DAILY_AVG = YEARLY_GOAL / 365.0;
+    
+    if (&stats != &m_stats) {
+        m_stats = stats;
+    }
+    publish_statistics(stats);
+    
+    TextBuffer text;
+    
+    if (stats.entry_count == 0) {
+        text << "Total: 0.0 km";
+        set_label_text(m_total_label, m_total_text, text);
+        text.clear();
+        text << "Entries: 0";
+        set_label_text(m_count_label, m_count_text, text);
+        text.clear();
+        text << "Daily Average: 0.0 km/day (Need: " << REQUIRED_DAILY_AVG << " km/day)";
+        set_label_text(m_daily_avg_label, m_pacer_text, text);
+        text.clear();
+        text << "Goal Progress: 0.0 / 1000 km (0%)";
+        set_label_text(m_goal_label, m_goal_text, text);
+        return;
+    }
+    
+    double total = stats.total;
+    double pacer_km = stats.pacer_km;
+    double pace_difference = stats.daily_average - REQUIRED_DAILY_AVG;
     
-    std::ostringstream total_oss, count_oss, pacer_oss, goal_oss;
-    total_oss << "<b>Total: "  << total << " km</b>";
-    count_oss << "<b>Daily average: " << daily_average << " km</b>";
+    text << "Total: " << total << " km";
+    set_label_text(m_total_label, m_total_text, text);
     
-    pacer_oss << "<b> Pacer progress: " << std::setprecision(3) << REQUIRED_DAILY_AVG << " km/day, "<< 
-    pacer_km << "km total, ";
+    text.clear();
+    text << "Daily average: " << stats.daily_average << " km";
+    set_label_text(m_count_label, m_count_text, text);
+    
+    text.clear();
+    text.set_precision(3);
+    text << "Pacer progress: " << REQUIRED_DAILY_AVG << " km/day, " << pacer_km << "km total, ";
     if (pace_difference >= 0) {
-        pacer_oss   << total - pacer_km << " km behind";
+        text << total - pacer_km << " km behind";
     } else {
-        pacer_oss  << pacer_km - total << " km ahead";
+        text << pacer_km - total << " km ahead";
     }
-    pacer_oss << "</b>";
-    
-    goal_oss << "<b>Progress to goal: "  << total 
-             << " / " << static_cast<int>(YEARLY_GOAL) << " km (" 
-             << progress_percent << "%)</b>";
+    set_label_text(m_daily_avg_label, m_pacer_text, text);
     
-    m_total_label->setText(QString::fromStdString(total_oss.str()));
-    m_count_label->setText(QString::fromStdString(count_oss.str()));
-    m_daily_avg_label->setText(QString::fromStdString(pacer_oss.str()));
-    m_goal_label->setText(QString::fromStdString(goal_oss.str()));
+    text.clear();
+    text.set_precision(6);
+    text << "Progress to goal: " << total << " / " << static_cast<int>(YEARLY_GOAL) << " km ("
+         << stats.progress_percent << "%)";
+    set_label_text(m_goal_label, m_goal_text, text);
     
     // Update track widget
     m_track_widget->setProgress(total, YEARLY_GOAL);
 }
 
-void MainWindow::save_to_file() {
-    std::ofstream file(m_data_file.toStdString());
+void MainWindow::start_stats_server(quint16 port) {
+    if (m_stats_server) {
+        return;
+    }
     
-    if (!file.is_open()) {
-        QMessageBox::warning(this, "Warning", 
-            "Could not save data to file:\n" + m_data_file);
+    m_stats_server = new StatsServer(this);
+    if (!m_stats_server->start(port)) {
+        QMessageBox::warning(this, "Warning",
+            "Could not start stats server on port " + QString::number(port));
+        delete m_stats_server;
+        m_stats_server = nullptr;
+        return;
+    }
+    
+    publish_statistics(m_stats);
+}
+
+void MainWindow::publish_statistics(const RunningStats& stats) {
+    if (!m_stats_server) {
         return;
     }
     
+    // Newest first, same window as the history list
+    QJsonArray recent;
+    for (auto it = m_entries.rbegin(); it != m_entries.rend() && it != m_entries.rbegin() + 20; ++it) {
+        QJsonObject entry;
+        entry["date"] = QString::fromStdString(it->date);
+        entry["kilometers"] = it->kilometers;
+        recent.append(entry);
+    }
+    
+    QJsonObject root;
+    root["total_km"] = stats.total;
+    root["entries"] = stats.entry_count;
+    root["goal_km"] = YEARLY_GOAL;
+    root["goal_progress_percent"] = stats.progress_percent;
+    root["daily_average_km"] = stats.daily_average;
+    root["pacer_km"] = stats.pacer_km;
+    root["pacer_delta_km"] = stats.total - stats.pacer_km;
+    root["recent"] = recent;
+    
+    QJsonObject monthly;
+    for (const auto& month : stats.monthly_km) {
+        monthly[QString::fromStdString(month.first)] = month.second;
+    }
+    root["monthly_km"] = monthly;
+    
+    m_stats_server->publish(QJsonDocument(root).toJson(QJsonDocument::Compact));
+}
+
+void MainWindow::update_chart() {
+    // Entries are only ever appended between invalidations, so an unchanged
+    // count means nothing to do and new entries usually just extend the series
+    if (m_chart_valid && m_chart_entry_count == m_entries.size()) {
+        return;
+    }
+    if (m_chart_valid && m_chart_entry_count < m_entries.size() && append_to_chart()) {
+        return;
+    }
+    
+    m_chart_valid = true;
+    m_chart_entry_count = m_entries.size();
+    m_chart_total_km = 0.0;
+    m_chart_last_day = -1;
+    if (m_entries.empty()) {
+        m_chart_widget->setSeries(QVector<QPointF>(), 0.0, 0.0);
+        return;
+    }
+    
+    // Dates are yyyy-MM-dd so string order is chronological
+    std::vector<const RunningEntry*>& sorted = m_chart_order;
+    sorted.clear();
+    sorted.reserve(m_entries.size());
     for (const auto& entry : m_entries) {
-        file << entry.date << "," 
-             << entry.kilometers << "\n";
+        sorted.push_back(&entry);
+    }
+    // Ties keep insertion order via the address; std::stable_sort would allocate a buffer
+    std::sort(sorted.begin(), sorted.end(),
+              [](const RunningEntry* a, const RunningEntry* b) {
+                  int order = a->date.compare(b->date);
+                  return order < 0 || (order == 0 && a < b);
+              });
+    
+    QVector<QPointF> points;
+    points.reserve(static_cast<int>(sorted.size()));
+    double cumulative = 0.0;
+    for (const RunningEntry* entry : sorted) {
+        QDate date = parse_iso_date(entry->date);
+        if (!date.isValid()) continue;
+        cumulative += entry->kilometers;
+        points.append(QPointF(date.toJulianDay(), cumulative));
+    }
+    m_chart_total_km = cumulative;
+    
+    // Pacer starts on January 1st of the first tracked year
+    double pacer_origin = 0.0;
+    if (!points.isEmpty()) {
+        m_chart_last_day = static_cast<qint64>(points.last().x());
+        QDate first = QDate::fromJulianDay(static_cast<qint64>(points.first().x()));
+        pacer_origin = QDate(first.year(), 1, 1).toJulianDay();
     }
     
-    file.close();
+    m_chart_widget->setSeries(std::move(points), pacer_origin, YEARLY_GOAL / 365.0);
 }
 
-void MainWindow::load_from_file() {
-    std::ifstream file(m_data_file.toStdString());
+bool MainWindow::append_to_chart() {
+    if (m_chart_last_day < 0) {
+        return false;
+    }
+    
+    // Only entries dated on or after the end of the series can be appended;
+    // anything earlier needs the full sort
+    qint64 last_day = m_chart_last_day;
+    for (size_t i = m_chart_entry_count; i < m_entries.size(); ++i) {
+        QDate date = parse_iso_date(m_entries[i].date);
+        if (!date.isValid()) continue;
+        if (date.toJulianDay() < last_day) return false;
+        last_day = date.toJulianDay();
+    }
+    
+    for (size_t i = m_chart_entry_count; i < m_entries.size(); ++i) {
+        QDate date = parse_iso_date(m_entries[i].date);
+        if (!date.isValid()) continue;
+        m_chart_total_km += m_entries[i].kilometers;
+        m_chart_last_day = date.toJulianDay();
+        m_chart_widget->appendPoint(QPointF(m_chart_last_day, m_chart_total_km));
+    }
+    m_chart_entry_count = m_entries.size();
+    return true;
+}
+
+void MainWindow::save_to_file(const RunningStats& stats) {
+    // Same text as streaming each entry, built into a buffer kept between saves.
+    // Dates are copied as is so nothing is truncated; only the number is formatted.
+    m_file_text.clear();
+    TextBuffer km;
+    for (const auto& entry : m_entries) {
+        km.clear();
+        km << entry.kilometers;
+        m_file_text += entry.date;
+        m_file_text += ',';
+        m_file_text.append(km.c_str(), km.size());
+        m_file_text += '\n';
+    }
+    
+    std::ofstream file(m_data_file.toStdString());
     
     if (!file.is_open()) {
-        // File doesn't exist yet, which is fine for first run
+        QMessageBox::warning(this, "Warning", 
+            "Could not save data to file:\n" + m_data_file);
         return;
     }
     
-    m_entries.clear();
-    std::string line;
+    file.write(m_file_text.data(), m_file_text.size());
+    file.close();
     
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-        
-        size_t comma_pos = line.find(',');
-        if (comma_pos == std::string::npos) continue;
-        
-        std::string date = line.substr(0, comma_pos);
-        std::string km_str = line.substr(comma_pos + 1);
+    // Record what was just written so the next launch can trust the cache
+    m_data_stamp = stat_data_file(m_data_file);
+    m_data_stamp.hash = hash_data_file_contents(
+        QByteArray::fromRawData(m_file_text.data(), static_cast<int>(m_file_text.size())));
+    write_stats_cache(stats_cache_path(m_data_file), m_data_stamp, stats);
+}
 
-        float kilometers;
-        try {
-            kilometers = my_stod(km_str);
-            m_entries.emplace_back(date, kilometers);
-        } catch (const std::exception&) {
-            // Skip invalid lines
-            continue;
+void MainWindow::load_from_file() {
+    DataFileContents data = read_data_file(m_data_file);
+    m_entries = std::move(data.entries);
+    m_chart_valid = false;
+    m_data_stamp = data.stamp;
+}
+
+bool MainWindow::load_cached_statistics(RunningStats& stats) {
+    DataFileStamp cached;
+    if (!load_stats_cache(m_data_file, cached, stats)) {
+        return false;
+    }
+    
+    fill_derived_statistics(stats);
+    m_data_stamp = cached;
+    return true;
+}
+
+void MainWindow::start_background_load() {
+    // Editing before the entries arrive would overwrite the file with a partial list
+    set_input_enabled(false);
+    m_list_view->setPlainText("Loading entries...\n");
+    m_load_watcher.setFuture(QtConcurrent::run(read_data_file, m_data_file));
+}
+
+void MainWindow::on_background_load_finished() {
+    DataFileContents data = m_load_watcher.result();
+    bool cache_matches = stats_cache_confirmed(m_data_stamp, data.stamp);
+    
+    m_entries = std::move(data.entries);
+    m_chart_valid = false;
+    m_data_stamp = data.stamp;
+    
+    if (cache_matches) {
+        // Statistics are already on screen, only the recent entries were missing
+        publish_statistics(m_stats);
+    } else {
+        // Contents changed without touching size or mtime
+        compute_statistics(m_stats);
+        show_statistics(m_stats);
+        if (m_data_stamp.exists()) {
+            write_stats_cache(stats_cache_path(m_data_file), m_data_stamp, m_stats);
         }
     }
     
-    file.close();
+    update_list_view();
+    update_chart();
+    set_input_enabled(true);
+}
+
+void MainWindow::set_input_enabled(bool enabled) {
+    m_date_edit->setEnabled(enabled);
+    m_kilometers_entry->setEnabled(enabled);
+    m_add_button->setEnabled(enabled);
+    m_remove_last_button->setEnabled(enabled);
+    m_import_button->setEnabled(enabled);
 }
 
 void MainWindow::save_and_update_ui() {
-    save_to_file();
+    compute_statistics(m_stats);
+    save_to_file(m_stats);
     update_list_view();
-    update_statistics();
+    show_statistics(m_stats);
+    update_chart();
 }
 
 int MainWindow::get_day_of_year() const {
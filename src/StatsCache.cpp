@@ -0,0 +1,156 @@
+#include "StatsCache.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QCryptographicHash>
+
+namespace {
+
+// Bump whenever the set of cached aggregates changes
+const int CACHE_VERSION = 2;
+const char MONTH_PREFIX[] = "month.";
+
+QByteArray format_double(double value) {
+    return QByteArray::number(value, 'g', 17);
+}
+
+}  // namespace
+
+DataFileStamp stat_data_file(const QString& path) {
+    DataFileStamp stamp;
+    QFileInfo info(path);
+    if (info.exists()) {
+        stamp.size = info.size();
+        stamp.mtime_ms = info.lastModified().toMSecsSinceEpoch();
+    }
+    return stamp;
+}
+
+QByteArray hash_data_file_contents(const QByteArray& contents) {
+    return QCryptographicHash::hash(contents, QCryptographicHash::Sha1).toHex();
+}
+
+QString stats_cache_path(const QString& data_file) {
+    return data_file + ".stats";
+}
+
+bool read_stats_cache(const QString& path, DataFileStamp& stamp, RunningStats& stats) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    
+    DataFileStamp cached;
+    RunningStats result;
+    bool version_ok = false;
+    bool size_ok = false;
+    bool mtime_ok = false;
+    bool total_ok = false;
+    bool count_ok = false;
+    bool days_ok = false;
+    bool end_ok = false;
+    
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine().trimmed();
+        int separator = line.indexOf('=');
+        if (separator <= 0) continue;
+        
+        QByteArray key = line.left(separator);
+        QByteArray value = line.mid(separator + 1);
+        
+        if (end_ok) {
+            // Nothing may follow the end marker
+            return false;
+        } else if (key == "end") {
+            end_ok = value == "1";
+        } else if (key == "version") {
+            version_ok = value.toInt() == CACHE_VERSION;
+        } else if (key == "size") {
+            cached.size = value.toLongLong(&size_ok);
+        } else if (key == "mtime") {
+            cached.mtime_ms = value.toLongLong(&mtime_ok);
+        } else if (key == "hash") {
+            cached.hash = value;
+        } else if (key == "total") {
+            result.total = value.toDouble(&total_ok);
+        } else if (key == "entries") {
+            result.entry_count = value.toInt(&count_ok);
+        } else if (key == "days_tracked") {
+            result.days_tracked = value.toInt(&days_ok);
+        } else if (key == "earliest") {
+            result.earliest = value.toStdString();
+        } else if (key == "latest") {
+            result.latest = value.toStdString();
+        } else if (key.startsWith(MONTH_PREFIX)) {
+            bool ok;
+            double km = value.toDouble(&ok);
+            if (!ok) return false;
+            result.monthly_km[key.mid(sizeof(MONTH_PREFIX) - 1).toStdString()] = km;
+        }
+    }
+    
+    // A partially written or foreign file is treated as no cache at all
+    if (!version_ok || !size_ok || !mtime_ok || cached.hash.isEmpty() ||
+        !total_ok || !count_ok || !days_ok || !end_ok) {
+        return false;
+    }
+    
+    stamp = cached;
+    stats = result;
+    return true;
+}
+
+bool write_stats_cache(const QString& path, const DataFileStamp& stamp, const RunningStats& stats) {
+    // QSaveFile replaces the old cache atomically so readers never see half a file
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    
+    QByteArray contents;
+    contents += "version=" + QByteArray::number(CACHE_VERSION) + "\n";
+    contents += "size=" + QByteArray::number(stamp.size) + "\n";
+    contents += "mtime=" + QByteArray::number(stamp.mtime_ms) + "\n";
+    contents += "hash=" + stamp.hash + "\n";
+    contents += "total=" + format_double(stats.total) + "\n";
+    contents += "entries=" + QByteArray::number(stats.entry_count) + "\n";
+    contents += "days_tracked=" + QByteArray::number(stats.days_tracked) + "\n";
+    contents += "earliest=" + QByteArray::fromStdString(stats.earliest) + "\n";
+    contents += "latest=" + QByteArray::fromStdString(stats.latest) + "\n";
+    for (const auto& month : stats.monthly_km) {
+        contents += MONTH_PREFIX + QByteArray::fromStdString(month.first) + "=" +
+                    format_double(month.second) + "\n";
+    }
+    // Written last so a truncated file is never mistaken for a complete one
+    contents += "end=1\n";
+    
+    file.write(contents);
+    return file.commit();
+}
+
+bool load_stats_cache(const QString& data_file, DataFileStamp& stamp, RunningStats& stats) {
+    DataFileStamp current = stat_data_file(data_file);
+    if (!current.exists()) {
+        return false;
+    }
+    
+    DataFileStamp cached;
+    RunningStats cached_stats;
+    if (!read_stats_cache(stats_cache_path(data_file), cached, cached_stats)) {
+        return false;
+    }
+    
+    // Any external edit changes size or mtime; the hash is checked after loading
+    if (cached.size != current.size || cached.mtime_ms != current.mtime_ms) {
+        return false;
+    }
+    
+    stamp = cached;
+    stats = cached_stats;
+    return true;
+}
+
+bool stats_cache_confirmed(const DataFileStamp& cached, const DataFileStamp& loaded) {
+    return loaded.exists() && !cached.hash.isEmpty() && cached.hash == loaded.hash;
+}
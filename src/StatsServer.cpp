@@ -0,0 +1,131 @@
+#include "StatsServer.h"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QMetaObject>
+#include <QTimer>
+
+namespace {
+
+// Requests larger than this are not something the dashboard sends
+const qint64 MAX_REQUEST_SIZE = 8192;
+
+// Clients that have not sent a full request by then are dropped
+const int DEFAULT_IDLE_TIMEOUT_MS = 5000;
+
+}  // namespace
+
+StatsServer::StatsServer(QObject *parent)
+    : QObject(parent),
+      m_tcp_server(nullptr),
+      m_port(0),
+      m_idle_timeout_ms(DEFAULT_IDLE_TIMEOUT_MS)
+{
+    publish("{}");
+}
+
+StatsServer::~StatsServer() {
+    m_thread.quit();
+    m_thread.wait();
+}
+
+bool StatsServer::start(quint16 port) {
+    if (m_tcp_server) {
+        return false;
+    }
+    
+    // The server and its sockets live on m_thread and are deleted with it
+    m_tcp_server = new QTcpServer();
+    m_tcp_server->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_tcp_server, &QObject::deleteLater);
+    connect(m_tcp_server, &QTcpServer::newConnection, m_tcp_server, [this]() {
+        acceptConnections();
+    });
+    m_thread.start();
+    
+    bool listening = false;
+    QMetaObject::invokeMethod(m_tcp_server, [this, port, &listening]() {
+        listening = m_tcp_server->listen(QHostAddress::LocalHost, port);
+        m_port = m_tcp_server->serverPort();
+    }, Qt::BlockingQueuedConnection);
+    
+    return listening;
+}
+
+quint16 StatsServer::port() const {
+    return m_port;
+}
+
+void StatsServer::setIdleTimeout(int msec) {
+    m_idle_timeout_ms.store(msec);
+}
+
+void StatsServer::publish(const QByteArray& json) {
+    auto response = std::make_shared<const QByteArray>(buildResponse("200 OK", json));
+    std::atomic_store(&m_stats_response, std::shared_ptr<const QByteArray>(std::move(response)));
+}
+
+QByteArray StatsServer::buildResponse(const QByteArray& status, const QByteArray& body) {
+    QByteArray response;
+    response.reserve(body.size() + 128);
+    response += "HTTP/1.1 " + status + "\r\n";
+    response += "Content-Type: application/json\r\n";
+    response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    response += "Cache-Control: no-store\r\n";
+    response += "Connection: close\r\n\r\n";
+    response += body;
+    return response;
+}
+
+void StatsServer::acceptConnections() {
+    while (QTcpSocket *socket = m_tcp_server->nextPendingConnection()) {
+        connect(socket, &QTcpSocket::readyRead, socket, [this, socket]() {
+            handleRequest(socket);
+        });
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        
+        // A client that never finishes its request must not hold the socket forever
+        QTimer *timeout = new QTimer(socket);
+        timeout->setSingleShot(true);
+        connect(timeout, &QTimer::timeout, socket, &QTcpSocket::abort);
+        timeout->start(m_idle_timeout_ms.load());
+    }
+}
+
+void StatsServer::handleRequest(QTcpSocket *socket) {
+    static const QByteArray notFound = buildResponse("404 Not Found", "{\"error\":\"not found\"}");
+    static const QByteArray notAllowed = buildResponse("405 Method Not Allowed",
+                                                       "{\"error\":\"method not allowed\"}");
+    
+    // Wait until the whole header block has arrived
+    QByteArray buffered = socket->peek(socket->bytesAvailable());
+    if (!buffered.contains("\r\n\r\n")) {
+        if (buffered.size() > MAX_REQUEST_SIZE) {
+            socket->abort();
+        }
+        return;
+    }
+    
+    QByteArray request = socket->readAll();
+    QList<QByteArray> requestLine = request.left(request.indexOf("\r\n")).split(' ');
+    
+    // Dashboards append cache-busters like ?t=123, only the path selects the resource
+    QByteArray path = requestLine.size() >= 2 ? requestLine[1] : QByteArray();
+    int query = path.indexOf('?');
+    if (query >= 0) {
+        path.truncate(query);
+    }
+    
+    if (requestLine.size() < 2 || requestLine[0] != "GET") {
+        socket->write(notAllowed);
+    } else if (path == "/" || path == "/stats") {
+        std::shared_ptr<const QByteArray> response = std::atomic_load(&m_stats_response);
+        socket->write(*response);
+    } else {
+        socket->write(notFound);
+    }
+    
+    // One request per connection; anything sent after it is ignored
+    disconnect(socket, &QTcpSocket::readyRead, nullptr, nullptr);
+    socket->disconnectFromHost();
+}
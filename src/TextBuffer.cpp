@@ -0,0 +1,81 @@
+#include "TextBuffer.h"
+#include <algorithm>
+#include <charconv>
+#include <clocale>
+#include <cstdio>
+#include <cstring>
+
+void TextBuffer::append(const char *text, std::size_t length) {
+    length = std::min(length, CAPACITY - 1 - m_size);
+    std::memcpy(m_data + m_size, text, length);
+    m_size += length;
+    m_data[m_size] = '\0';
+}
+
+void TextBuffer::append_spaces(std::size_t count) {
+    count = std::min(count, CAPACITY - 1 - m_size);
+    std::memset(m_data + m_size, ' ', count);
+    m_size += count;
+    m_data[m_size] = '\0';
+}
+
+void TextBuffer::append_left(const char *text, std::size_t length, std::size_t width) {
+    append(text, length);
+    if (length < width) append_spaces(width - length);
+}
+
+void TextBuffer::append_right(const char *text, std::size_t length, std::size_t width) {
+    if (length < width) append_spaces(width - length);
+    append(text, length);
+}
+
+TextBuffer& TextBuffer::operator<<(const char *text) {
+    append(text, std::strlen(text));
+    return *this;
+}
+
+TextBuffer& TextBuffer::operator<<(const std::string& text) {
+    append(text.data(), text.size());
+    return *this;
+}
+
+TextBuffer& TextBuffer::operator<<(double value) {
+    char digits[32];
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto result = std::to_chars(digits, digits + sizeof(digits), value,
+                                std::chars_format::general, m_precision);
+    append(digits, result.ptr - digits);
+#else
+    // Floating-point to_chars needs GCC 11 or newer; snprintf honours the
+    // C locale, so swap its decimal separator back to '.'
+    int length = std::snprintf(digits, sizeof(digits), "%.*g", m_precision, value);
+    length = std::min(std::max(length, 0), static_cast<int>(sizeof(digits)) - 1);
+    const char *point = std::localeconv()->decimal_point;
+    std::size_t point_length = std::strlen(point);
+    if (point_length > 0 && std::strcmp(point, ".") != 0) {
+        char *found = std::strstr(digits, point);
+        if (found) {
+            *found = '.';
+            std::memmove(found + 1, found + point_length,
+                         digits + length + 1 - (found + point_length));
+            length -= static_cast<int>(point_length) - 1;
+        }
+    }
+    append(digits, length);
+#endif
+    return *this;
+}
+
+TextBuffer& TextBuffer::operator<<(int value) {
+    char digits[16];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    append(digits, result.ptr - digits);
+    return *this;
+}
+
+TextBuffer& TextBuffer::operator<<(std::size_t value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    append(digits, result.ptr - digits);
+    return *this;
+}
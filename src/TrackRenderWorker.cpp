@@ -0,0 +1,81 @@
+#include "TrackRenderWorker.h"
+#include <QPainter>
+
+TrackRenderWorker::TrackRenderWorker(QObject *parent)
+    : QObject(parent),
+      m_pending_generation(0),
+      m_render_queued(false),
+      m_next_buffer(0),
+      m_latest_generation(0)
+{
+}
+
+void TrackRenderWorker::submit(const TrackScene& scene, quint64 generation) {
+    // Marks any frame still being drawn as stale
+    m_latest_generation.store(generation, std::memory_order_release);
+    
+    QMutexLocker locker(&m_pending_mutex);
+    m_pending_scene = scene;
+    m_pending_generation = generation;
+    if (m_render_queued) {
+        return;
+    }
+    m_render_queued = true;
+    QMetaObject::invokeMethod(this, "renderPending", Qt::QueuedConnection);
+}
+
+void TrackRenderWorker::renderPending() {
+    quint64 generation;
+    {
+        QMutexLocker locker(&m_pending_mutex);
+        // QString members are shared, so this copy only touches reference counts
+        m_scene = m_pending_scene;
+        generation = m_pending_generation;
+        m_render_queued = false;
+    }
+    render(m_scene, generation);
+}
+
+bool TrackRenderWorker::isStale(quint64 generation) const {
+    return generation != m_latest_generation.load(std::memory_order_acquire);
+}
+
+QImage& TrackRenderWorker::acquireBuffer(const QSize& size, qreal devicePixelRatio) {
+    // A buffer is free again once the widget has dropped its copy of it
+    for (QImage& buffer : m_buffers) {
+        if (buffer.size() == size && buffer.devicePixelRatio() == devicePixelRatio &&
+            buffer.isDetached()) {
+            return buffer;
+        }
+    }
+    
+    // Size changed or both buffers are still referenced: allocate into the next slot
+    QImage& buffer = m_buffers[m_next_buffer];
+    m_next_buffer = (m_next_buffer + 1) % 2;
+    buffer = QImage(size, QImage::Format_ARGB32_Premultiplied);
+    buffer.setDevicePixelRatio(devicePixelRatio);
+    return buffer;
+}
+
+void TrackRenderWorker::render(const TrackScene& scene, quint64 generation) {
+    // Skip requests that were already replaced while waiting for the thread
+    if (isStale(generation) || scene.width <= 0 || scene.height <= 0) {
+        return;
+    }
+    
+    QImage& frame = acquireBuffer(QSize(static_cast<int>(scene.width * scene.devicePixelRatio),
+                                        static_cast<int>(scene.height * scene.devicePixelRatio)),
+                                  scene.devicePixelRatio);
+    frame.fill(Qt::transparent);
+    
+    QPainter painter(&frame);
+    TrackWidget::renderScene(painter, scene);
+    painter.end();
+    
+    // Inputs changed mid-render, a newer request is already queued
+    if (isStale(generation)) {
+        return;
+    }
+    
+    emit frameReady(frame, generation);
+}
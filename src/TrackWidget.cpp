@@ -1,26 +1,148 @@
 #include "TrackWidget.h"
+#include "TrackRenderWorker.h"
 #include <QPainter>
 #include <QPen>
 #include <QBrush>
 #include <QFont>
+#include <QFontDatabase>
 #include <QDate>
+#include <QDateTime>
+#include <QTime>
 
 TrackWidget::TrackWidget(QWidget *parent)
     : QWidget(parent),
       m_current_km(0.0),
       m_total_km(1000.0),
-      m_progress_percent(0.0)
+      m_progress_percent(0.0),
+      m_threaded_rendering(false),
+      m_generation(0),
+      m_render_worker(nullptr)
 {
     setMinimumSize(400, 350);
+    updateProgressText();
+    updateDimensionText();
+    
+    // The pacer marker depends on today's date, so redraw when it changes
+    m_midnight_timer.setSingleShot(true);
+    m_midnight_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_midnight_timer, &QTimer::timeout, this, &TrackWidget::onDateChanged);
+    armMidnightTimer();
+    
+    // The worker draws text, which not every platform allows off the GUI thread
+    setThreadedRendering(QFontDatabase::supportsThreadedFontRendering());
+}
+
+TrackWidget::~TrackWidget() {
+    m_render_thread.quit();
+    m_render_thread.wait();
 }
 
 void TrackWidget::setProgress(double current, double total) {
+    if (current == m_current_km && total == m_total_km) {
+        return;
+    }
     m_current_km = current;
     m_total_km = total;
     m_progress_percent = (total > 0) ? (current / total) * 100.0 : 0.0;
+    updateProgressText();
+    requestFrame();
+}
+
+void TrackWidget::updateProgressText() {
+    // Built once per change so frames do not format text
+    m_progress_text = QString::number(m_progress_percent, 'f', 1) + QLatin1Char('%');
+    m_km_text = QString::number(m_current_km, 'f', 1) + QLatin1String(" / ") + 
+                QString::number(m_total_km, 'f', 0) + QLatin1String(" km");
+}
+
+void TrackWidget::updateDimensionText() {
+    int trackWidth, trackHeight;
+    trackDimensions(width(), height(), trackWidth, trackHeight);
+    
+    // Track perimeter is scaled to 1000km
+    double kmPerPixel = 1000.0 / calculateTrackPerimeter(trackWidth, trackHeight);
+    m_width_text = QString::number(trackWidth * kmPerPixel, 'f', 2) + QLatin1String(" km");
+    m_height_text = QString::number(trackHeight * kmPerPixel, 'f', 2) + QLatin1String(" km");
+}
+
+void TrackWidget::trackDimensions(int width, int height, int& trackWidth, int& trackHeight) {
+    // Stadium shape (larger)
+    int size = std::min(width, height) - 20;
+    trackWidth = size * 1.4;
+    trackHeight = size * 0.8;
+}
+
+void TrackWidget::setThreadedRendering(bool enabled) {
+    if (enabled == m_threaded_rendering) {
+        return;
+    }
+    m_threaded_rendering = enabled;
+    m_frame = QImage();
+    
+    if (enabled && !m_render_worker) {
+        m_render_worker = new TrackRenderWorker();
+        m_render_worker->moveToThread(&m_render_thread);
+        connect(&m_render_thread, &QThread::finished, m_render_worker, &QObject::deleteLater);
+        connect(m_render_worker, &TrackRenderWorker::frameReady, this, &TrackWidget::onFrameReady);
+        m_render_thread.start();
+    }
+    
+    requestFrame();
+}
+
+TrackScene TrackWidget::currentScene() const {
+    TrackScene scene;
+    scene.width = width();
+    scene.height = height();
+    scene.devicePixelRatio = devicePixelRatioF();
+    scene.currentKm = m_current_km;
+    scene.totalKm = m_total_km;
+    scene.progressPercent = m_progress_percent;
+    scene.dayOfYear = get_day_of_year();
+    scene.progressText = m_progress_text;
+    scene.kmText = m_km_text;
+    scene.widthText = m_width_text;
+    scene.heightText = m_height_text;
+    return scene;
+}
+
+void TrackWidget::requestFrame() {
+    if (!m_threaded_rendering) {
+        update();
+        return;
+    }
+    
+    // Bumping the generation marks any frame still in flight as stale
+    ++m_generation;
+    m_render_worker->submit(currentScene(), m_generation);
+}
+
+void TrackWidget::onFrameReady(const QImage& frame, quint64 generation) {
+    if (generation != m_generation) {
+        return;
+    }
+    m_frame = frame;
     update();
 }
 
+void TrackWidget::onDateChanged() {
+    requestFrame();
+    armMidnightTimer();
+}
+
+void TrackWidget::armMidnightTimer() {
+    QDateTime now = QDateTime::currentDateTime();
+    QDateTime midnight(now.date().addDays(1), QTime(0, 0));
+    // Fire slightly late so get_day_of_year() already returns the new day
+    m_midnight_timer.start(static_cast<int>(now.msecsTo(midnight)) + 1000);
+}
+
+void TrackWidget::resizeEvent(QResizeEvent *event) {
+    QWidget::resizeEvent(event);
+    updateDimensionText();
+    requestFrame();
+}
+
 QSize TrackWidget::sizeHint() const {
     return QSize(500, 450);
 }
@@ -29,7 +151,7 @@ QSize TrackWidget::minimumSizeHint() const {
     return QSize(400, 350);
 }
 
-double TrackWidget::calculateTrackPerimeter(int trackWidth, int trackHeight) const {
+double TrackWidget::calculateTrackPerimeter(int trackWidth, int trackHeight) {
     double straightLength = trackWidth - trackHeight;
     double semiCircleLength = M_PI * (trackHeight / 2.0);
     return 2 * straightLength + 2 * semiCircleLength;
@@ -89,17 +211,29 @@ void TrackWidget::paintEvent(QPaintEvent *event) {
     Q_UNUSED(event);
     
     QPainter painter(this);
+    
+    if (!m_threaded_rendering) {
+        renderScene(painter, currentScene());
+        return;
+    }
+    
+    // Blit the latest completed frame; nothing is drawn until the first one arrives
+    if (!m_frame.isNull()) {
+        painter.drawImage(0, 0, m_frame);
+    }
+}
+
+void TrackWidget::renderScene(QPainter& painter, const TrackScene& scene) {
     painter.setRenderHint(QPainter::Antialiasing);
     
-    int width = this->width();
-    int height = this->height();
-    int size = std::min(width, height) - 20;
+    int width = scene.width;
+    int height = scene.height;
     int centerX = width / 2;
     int centerY = height / 2;
     
-    // Track dimensions - stadium shape (larger)
-    int trackWidth = size * 1.4;
-    int trackHeight = size * 0.8;
+    // Track dimensions
+    int trackWidth, trackHeight;
+    trackDimensions(width, height, trackWidth, trackHeight);
     int trackThickness = 35;
     int cornerRadius = trackHeight / 2;  // Semicircular ends
     
@@ -123,9 +257,8 @@ void TrackWidget::paintEvent(QPaintEvent *event) {
     painter.drawPath(trackPath);
     
     // Calculate required pace position (based on day of year)
-    int dayOfYear = get_day_of_year();
-    double requiredKm = (dayOfYear / 365.0) * m_total_km;
-    double requiredPercent = (m_total_km > 0) ? (requiredKm / m_total_km) * 100.0 : 0.0;
+    double requiredKm = (scene.dayOfYear / 365.0) * scene.totalKm;
+    double requiredPercent = (scene.totalKm > 0) ? (requiredKm / scene.totalKm) * 100.0 : 0.0;
     
     // Draw required pace marker (cyan line with glow)
     if (requiredPercent > 0 && requiredPercent <= 100) {
@@ -134,8 +267,8 @@ void TrackWidget::paintEvent(QPaintEvent *event) {
     }
     
     // Draw current progress marker (red line with glow)
-    if (m_progress_percent > 0 && m_progress_percent <= 100) {
-        drawProgressMarker(painter, m_progress_percent, centerX, centerY, trackWidth, trackHeight,
+    if (scene.progressPercent > 0 && scene.progressPercent <= 100) {
+        drawProgressMarker(painter, scene.progressPercent, centerX, centerY, trackWidth, trackHeight,
                           trackThickness, QColor(220, 50, 50));
     }
     
@@ -144,22 +277,19 @@ void TrackWidget::paintEvent(QPaintEvent *event) {
     QFont font = painter.font();
     font.setPointSize(24);
     font.setBold(true);
-    font.setFamily("Monospace");
+    font.setFamily(QStringLiteral("Monospace"));
     painter.setFont(font);
     
-    QString progressText = QString::number(m_progress_percent, 'f', 1) + "%";
     QRect textRect(centerX - 100, centerY - 40, 200, 50);
-    painter.drawText(textRect, Qt::AlignCenter, progressText);
+    painter.drawText(textRect, Qt::AlignCenter, scene.progressText);
     
     // Draw km text
     font.setPointSize(12);
     font.setBold(false);
     painter.setFont(font);
     painter.setPen(QColor(0, 255, 136));  // Cyan-green
-    QString kmText = QString::number(m_current_km, 'f', 1) + " / " + 
-                     QString::number(m_total_km, 'f', 0) + " km";
     QRect kmRect(centerX - 100, centerY + 10, 200, 30);
-    painter.drawText(kmRect, Qt::AlignCenter, kmText);
+    painter.drawText(kmRect, Qt::AlignCenter, scene.kmText);
     
     // Draw color legend at bottom left
     int legendX = 15;
@@ -176,7 +306,7 @@ void TrackWidget::paintEvent(QPaintEvent *event) {
     painter.setBrush(QColor(220, 50, 50));
     painter.drawEllipse(QPointF(legendX + dotSize/2, legendY + dotSize/2), dotSize/2, dotSize/2);
     painter.setPen(QColor(200, 200, 200));
-    painter.drawText(legendX + dotSize + 8, legendY + dotSize + 2, "Your progress");
+    painter.drawText(legendX + dotSize + 8, legendY + dotSize + 2, QStringLiteral("Your progress"));
     
     // Cyan runner (required pace)
     legendY += lineHeight;
@@ -184,7 +314,7 @@ void TrackWidget::paintEvent(QPaintEvent *event) {
     painter.setBrush(QColor(0, 255, 255));
     painter.drawEllipse(QPointF(legendX + dotSize/2, legendY + dotSize/2), dotSize/2, dotSize/2);
     painter.setPen(QColor(200, 200, 200));
-    painter.drawText(legendX + dotSize + 8, legendY + dotSize + 2, "Required pace");
+    painter.drawText(legendX + dotSize + 8, legendY + dotSize + 2, QStringLiteral("Required pace"));
     
     // Draw startline
     painter.setPen(QPen(QColor(255, 255, 255, 150), 5));
@@ -195,10 +325,6 @@ void TrackWidget::paintEvent(QPaintEvent *event) {
     int dimOffset = 20;  // Distance from track edge to dimension line
     int tickSize = 8;    // Size of end ticks
     
-    // Calculate track perimeter to scale dimensions to 1000km
-    double totalPerimeter = calculateTrackPerimeter(trackWidth, trackHeight);
-    double kmPerPixel = 1000.0 / totalPerimeter;
-    
     // Top horizontal dimension line (showing width)
     int topLineY = centerY - trackHeight/2 - dimOffset;
     int leftX = centerX - trackWidth/2;
@@ -216,10 +342,8 @@ void TrackWidget::paintEvent(QPaintEvent *event) {
     font.setPointSize(9);
     painter.setFont(font);
     painter.setPen(QColor(120, 120, 120));
-    double widthKm = trackWidth * kmPerPixel;
-    QString widthText = QString::number(widthKm, 'f', 2) + " km";
     QRect widthRect(centerX - 40, topLineY - 20, 80, 15);
-    painter.drawText(widthRect, Qt::AlignCenter, widthText);
+    painter.drawText(widthRect, Qt::AlignCenter, scene.widthText);
     
     // Right vertical dimension line (showing height)
     int rightLineX = centerX + trackWidth/2 + dimOffset;
@@ -239,10 +363,8 @@ void TrackWidget::paintEvent(QPaintEvent *event) {
     painter.translate(rightLineX + 25, centerY);
     painter.rotate(-90);
     painter.setPen(QColor(120, 120, 120));
-    double heightKm = trackHeight * kmPerPixel;
-    QString heightText = QString::number(heightKm, 'f', 2) + " km";
     QRect heightRect(-40, -8, 80, 15);
-    painter.drawText(heightRect, Qt::AlignCenter, heightText);
+    painter.drawText(heightRect, Qt::AlignCenter, scene.heightText);
     painter.restore();
 }
 
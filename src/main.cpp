@@ -1,10 +1,28 @@
 #include "MainWindow.h"
 #include <QApplication>
+#include <QCommandLineParser>
 
 int main(int argc, char* argv[]) {
     QApplication app(argc, argv);
     
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption stats_port_option("stats-port",
+        "Serve statistics as JSON on http://127.0.0.1:<port>/stats", "port");
+    parser.addOption(stats_port_option);
+    parser.process(app);
+    
     MainWindow window;
+    
+    if (parser.isSet(stats_port_option)) {
+        bool ok;
+        uint port = parser.value(stats_port_option).toUInt(&ok);
+        if (!ok || port == 0 || port > 65535) {
+            parser.showHelp(1);
+        }
+        window.start_stats_server(static_cast<quint16>(port));
+    }
+    
     window.show();
     
     return app.exec();
@@ -0,0 +1,36 @@
+#include "Lttb.h"
+#include <QElapsedTimer>
+#include <cmath>
+#include <cstdio>
+
+// Times lttb_downsample on a multi-year-sized series at typical thresholds
+int main() {
+    const int POINT_COUNT = 10000000;
+    const int THRESHOLDS[] = { 800, 3200, 100000, 1000000 };
+    const int RUNS = 5;
+    
+    QVector<QPointF> points;
+    points.reserve(POINT_COUNT);
+    double y = 0.0;
+    for (int i = 0; i < POINT_COUNT; ++i) {
+        y += 5.0 + 4.0 * std::sin(i * 0.37);
+        points.append(QPointF(i, y));
+    }
+    
+    std::printf("lttb_downsample, %d points, best of %d runs\n", POINT_COUNT, RUNS);
+    for (int threshold : THRESHOLDS) {
+        qint64 best = -1;
+        int size = 0;
+        for (int run = 0; run < RUNS; ++run) {
+            QElapsedTimer timer;
+            timer.start();
+            QVector<QPointF> sampled = lttb_downsample(points, threshold);
+            qint64 elapsed = timer.nsecsElapsed();
+            size = sampled.size();
+            if (best < 0 || elapsed < best) best = elapsed;
+        }
+        std::printf("  threshold %8d -> %8d points: %8.2f ms\n", threshold, size, best / 1e6);
+    }
+    
+    return 0;
+}
@@ -0,0 +1,331 @@
+#include "MainWindow.h"
+#include <QtTest>
+#include <QImage>
+#include <QStandardPaths>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Every allocation on a thread that has counting switched on is tallied.
+// operator new is replaced for C++ code; on glibc malloc and friends are
+// interposed too, because Qt's containers allocate with malloc directly.
+// The render thread never counts, so only GUI thread work is measured.
+namespace {
+
+std::atomic<long> g_allocations(0);
+thread_local bool t_counting = false;
+
+void count_allocation() {
+    if (t_counting) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Counts allocations made on this thread while in scope
+class AllocationCounter {
+public:
+    AllocationCounter() : m_start(g_allocations.load()) { t_counting = true; }
+    ~AllocationCounter() { t_counting = false; }
+    
+    long count() const { return g_allocations.load() - m_start; }
+    
+private:
+    long m_start;
+};
+
+}  // namespace
+
+#if defined(__GLIBC__)
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+void __libc_free(void *pointer);
+
+void *malloc(size_t size) {
+    count_allocation();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    count_allocation();
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size) {
+    count_allocation();
+    return __libc_realloc(pointer, size);
+}
+
+void free(void *pointer) {
+    __libc_free(pointer);
+}
+}
+
+// operator new goes straight to glibc so one allocation is not counted twice
+static void *raw_allocate(std::size_t size) {
+    return __libc_malloc(size == 0 ? 1 : size);
+}
+
+static void raw_free(void *pointer) {
+    __libc_free(pointer);
+}
+#else
+static void *raw_allocate(std::size_t size) {
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+static void raw_free(void *pointer) {
+    std::free(pointer);
+}
+#endif
+
+void *operator new(std::size_t size) {
+    count_allocation();
+    void *pointer = raw_allocate(size);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void *operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    count_allocation();
+    return raw_allocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    count_allocation();
+    return raw_allocate(size);
+}
+
+void operator delete(void *pointer) noexcept { raw_free(pointer); }
+void operator delete[](void *pointer) noexcept { raw_free(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept { raw_free(pointer); }
+void operator delete[](void *pointer, std::size_t) noexcept { raw_free(pointer); }
+void operator delete(void *pointer, const std::nothrow_t&) noexcept { raw_free(pointer); }
+void operator delete[](void *pointer, const std::nothrow_t&) noexcept { raw_free(pointer); }
+
+// Allocation budgets for one add as seen by the GUI thread, per step. The
+// zero budgets are exact. The others count Qt's own work (QTextDocument,
+// QLabel, QPainter) and are set just above what that work needs, so any
+// per-entry or per-row allocation added to our code goes over them.
+const long COMPUTE_BUDGET = 0;
+const long LIST_BUDGET = 800;
+const long LABELS_BUDGET = 150;
+const long CHART_BUDGET = 8;
+const long CHART_PAINT_BUDGET = 300;
+const long RENDER_BUDGET = 400;
+// Allowed difference between a 100 and a 10000 entry history, per step
+const long SCALING_SLACK = 4;
+
+class AllocationTest : public QObject {
+    Q_OBJECT
+    
+private slots:
+    void initTestCase();
+    void init();
+    void counterSeesAllocations();
+    void unchangedRefreshDoesNotAllocate();
+    void addStaysWithinBudget();
+    void renderSceneStaysWithinBudget();
+    
+private:
+    // Fewest allocations seen for each step of adding one entry
+    struct AddCounts {
+        long compute = -1;
+        long save = -1;
+        long list = -1;
+        long labels = -1;
+        long chart = -1;
+        long chart_paint = -1;
+    };
+    
+    // Replaces the window's history with count entries spread over twelve months
+    static void fillEntries(MainWindow& window, int count);
+    static AddCounts measureAdd(MainWindow& window);
+};
+
+void AllocationTest::initTestCase() {
+    // Keep the user's data out of the test
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void AllocationTest::init() {
+    // Every window starts empty, so no background load can replace its entries
+    QString data_file = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) +
+                        "/running_data.txt";
+    QFile::remove(data_file);
+    QFile::remove(stats_cache_path(data_file));
+}
+
+void AllocationTest::counterSeesAllocations() {
+    // Guards against the replacements silently not being linked in
+    long count;
+    {
+        AllocationCounter counter;
+        QByteArray *bytes = new QByteArray(64, 'x');
+        delete bytes;
+        count = counter.count();
+    }
+    QVERIFY(count >= 1);
+}
+
+void AllocationTest::fillEntries(MainWindow& window, int count) {
+    window.m_entries.clear();
+    window.m_chart_valid = false;
+    // Headroom so the measured adds never reallocate the vector
+    window.m_entries.reserve(count + 16);
+    for (int i = 0; i < count; ++i) {
+        char date[] = "2024-01-01";
+        int month = i % 12 + 1;
+        int day = i % 28 + 1;
+        date[5] = static_cast<char>('0' + month / 10);
+        date[6] = static_cast<char>('0' + month % 10);
+        date[8] = static_cast<char>('0' + day / 10);
+        date[9] = static_cast<char>('0' + day % 10);
+        window.m_entries.emplace_back(date, 5.0 + i % 7);
+    }
+    
+    // Warm up buffers, labels, the month map and the chart for this history size
+    window.save_and_update_ui();
+    window.m_chart_widget->repaint();
+    window.m_entries.emplace_back("2024-12-31", 1.0);
+    window.save_and_update_ui();
+    window.m_chart_widget->repaint();
+}
+
+AllocationTest::AddCounts AllocationTest::measureAdd(MainWindow& window) {
+    const int CYCLES = 5;
+    
+    auto keepFewest = [](long& fewest, long count) {
+        fewest = (fewest < 0) ? count : std::min(fewest, count);
+    };
+    
+    // The same steps as save_and_update_ui(), counted one by one, plus the
+    // chart paint that follows; the add is always on the last day so the
+    // chart takes its append path
+    AddCounts counts;
+    for (int i = 0; i < CYCLES; ++i) {
+        window.m_entries.emplace_back("2024-12-31", 4.2);
+        {
+            AllocationCounter counter;
+            window.compute_statistics(window.m_stats);
+            keepFewest(counts.compute, counter.count());
+        }
+        {
+            AllocationCounter counter;
+            window.save_to_file(window.m_stats);
+            keepFewest(counts.save, counter.count());
+        }
+        {
+            AllocationCounter counter;
+            window.update_list_view();
+            keepFewest(counts.list, counter.count());
+        }
+        {
+            AllocationCounter counter;
+            window.show_statistics(window.m_stats);
+            keepFewest(counts.labels, counter.count());
+        }
+        {
+            AllocationCounter counter;
+            window.update_chart();
+            keepFewest(counts.chart, counter.count());
+        }
+        {
+            AllocationCounter counter;
+            window.m_chart_widget->repaint();
+            keepFewest(counts.chart_paint, counter.count());
+        }
+    }
+    return counts;
+}
+
+void AllocationTest::unchangedRefreshDoesNotAllocate() {
+    MainWindow window;
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    fillEntries(window, 100);
+    
+    long count;
+    {
+        AllocationCounter counter;
+        window.update_list_view();
+        window.show_statistics(window.m_stats);
+        window.update_chart();
+        count = counter.count();
+    }
+    QCOMPARE(count, 0L);
+}
+
+void AllocationTest::addStaysWithinBudget() {
+    MainWindow window;
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    
+    fillEntries(window, 100);
+    AddCounts small = measureAdd(window);
+    fillEntries(window, 10000);
+    AddCounts large = measureAdd(window);
+    
+    qInfo("allocations per add with 100 / 10000 entries: compute %ld / %ld, save %ld / %ld, "
+          "list %ld / %ld, labels %ld / %ld, chart %ld / %ld, chart paint %ld / %ld",
+          small.compute, large.compute, small.save, large.save, small.list, large.list,
+          small.labels, large.labels, small.chart, large.chart,
+          small.chart_paint, large.chart_paint);
+    
+    QCOMPARE(large.compute, COMPUTE_BUDGET);
+    QVERIFY2(large.list <= LIST_BUDGET, qPrintable(QString::number(large.list)));
+    QVERIFY2(large.labels <= LABELS_BUDGET, qPrintable(QString::number(large.labels)));
+    QVERIFY2(large.chart <= CHART_BUDGET, qPrintable(QString::number(large.chart)));
+    QVERIFY2(large.chart_paint <= CHART_PAINT_BUDGET, qPrintable(QString::number(large.chart_paint)));
+    
+    // Saving does file I/O and is not budgeted, but like every other step it
+    // must not allocate per entry
+    QVERIFY2(large.save <= small.save + SCALING_SLACK,
+             qPrintable(QString("save %1 vs %2").arg(large.save).arg(small.save)));
+    QVERIFY2(large.list <= small.list + SCALING_SLACK,
+             qPrintable(QString("list %1 vs %2").arg(large.list).arg(small.list)));
+    QVERIFY2(large.labels <= small.labels + SCALING_SLACK,
+             qPrintable(QString("labels %1 vs %2").arg(large.labels).arg(small.labels)));
+    QVERIFY2(large.chart_paint <= small.chart_paint + SCALING_SLACK,
+             qPrintable(QString("chart paint %1 vs %2").arg(large.chart_paint).arg(small.chart_paint)));
+}
+
+void AllocationTest::renderSceneStaysWithinBudget() {
+    TrackScene scene;
+    scene.width = 500;
+    scene.height = 450;
+    scene.totalKm = 1000.0;
+    scene.dayOfYear = 180;
+    scene.progressText = "0.0%";
+    scene.kmText = "0.0 / 1000 km";
+    scene.widthText = "389.61 km";
+    scene.heightText = "222.64 km";
+    
+    QImage frame(scene.width, scene.height, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&frame);
+    
+    // The first frame fills font and glyph caches
+    TrackWidget::renderScene(painter, scene);
+    
+    for (int percent = 0; percent <= 100; percent += 10) {
+        scene.currentKm = percent * 10.0;
+        scene.progressPercent = percent;
+        long count;
+        {
+            AllocationCounter counter;
+            TrackWidget::renderScene(painter, scene);
+            count = counter.count();
+        }
+        QVERIFY2(count <= RENDER_BUDGET,
+                 qPrintable(QString("%1 allocations at %2%").arg(count).arg(percent)));
+    }
+}
+
+QTEST_MAIN(AllocationTest)
+#include "test_allocations.moc"
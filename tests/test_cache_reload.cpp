@@ -0,0 +1,119 @@
+#include "MainWindow.h"
+#include <QtTest>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+class CacheReloadTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void matchingCacheIsKept();
+    void staleCacheIsRebuiltAfterBackgroundLoad();
+
+private:
+    void writeData(const QByteArray& contents);
+    // Writes a sidecar that describes the data file as it is now
+    void writeCache(const RunningStats& stats);
+    static RunningStats statsFor(double first_km, double second_km);
+    
+    QString m_data_file;
+};
+
+void CacheReloadTest::initTestCase() {
+    // Keep the user's data out of the test
+    QStandardPaths::setTestModeEnabled(true);
+    QString data_dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QVERIFY(QDir().mkpath(data_dir));
+    m_data_file = data_dir + "/running_data.txt";
+}
+
+void CacheReloadTest::init() {
+    QFile::remove(m_data_file);
+    QFile::remove(stats_cache_path(m_data_file));
+}
+
+void CacheReloadTest::writeData(const QByteArray& contents) {
+    QFile file(m_data_file);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QCOMPARE(file.write(contents), qint64(contents.size()));
+}
+
+void CacheReloadTest::writeCache(const RunningStats& stats) {
+    DataFileContents data = read_data_file(m_data_file);
+    QVERIFY(data.stamp.exists());
+    QVERIFY(write_stats_cache(stats_cache_path(m_data_file), data.stamp, stats));
+}
+
+RunningStats CacheReloadTest::statsFor(double first_km, double second_km) {
+    RunningStats stats;
+    stats.total = first_km + second_km;
+    stats.entry_count = 2;
+    stats.days_tracked = 32;
+    stats.earliest = "2024-01-01";
+    stats.latest = "2024-02-01";
+    stats.monthly_km["2024-01"] = first_km;
+    stats.monthly_km["2024-02"] = second_km;
+    return stats;
+}
+
+void CacheReloadTest::matchingCacheIsKept() {
+    writeData("2024-01-01,5.5\n2024-02-01,10.0\n");
+    writeCache(statsFor(5.5, 10.0));
+    QByteArray hash = read_data_file(m_data_file).stamp.hash;
+    
+    MainWindow window;
+    QCOMPARE(window.m_total_label->text(), QString("Total: 15.5 km"));
+    QVERIFY(!window.m_add_button->isEnabled());
+    
+    QTRY_VERIFY(window.m_add_button->isEnabled());
+    QCOMPARE(window.m_entries.size(), size_t(2));
+    QCOMPARE(window.m_total_label->text(), QString("Total: 15.5 km"));
+    
+    DataFileStamp cached;
+    RunningStats stats;
+    QVERIFY(read_stats_cache(stats_cache_path(m_data_file), cached, stats));
+    QCOMPARE(cached.hash, hash);
+}
+
+void CacheReloadTest::staleCacheIsRebuiltAfterBackgroundLoad() {
+    writeData("2024-01-01,5.5\n2024-02-01,10.0\n");
+    writeCache(statsFor(5.5, 10.0));
+    
+    // Same size and mtime, different contents: only the hash can tell
+    QDateTime modified = QFileInfo(m_data_file).lastModified();
+    writeData("2024-01-01,9.5\n2024-02-01,10.0\n");
+    {
+        QFile file(m_data_file);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.setFileTime(modified, QFileDevice::FileModificationTime));
+    }
+    DataFileStamp current = read_data_file(m_data_file).stamp;
+    
+    MainWindow window;
+    // The stale numbers are shown at first and editing waits for the real entries
+    QCOMPARE(window.m_total_label->text(), QString("Total: 15.5 km"));
+    QVERIFY(!window.m_add_button->isEnabled());
+    
+    QTRY_VERIFY(window.m_add_button->isEnabled());
+    QVERIFY(window.m_kilometers_entry->isEnabled());
+    QVERIFY(window.m_import_button->isEnabled());
+    QCOMPARE(window.m_entries.size(), size_t(2));
+    QCOMPARE(window.m_stats.total, 19.5);
+    QCOMPARE(window.m_total_label->text(), QString("Total: 19.5 km"));
+    
+    // The sidecar now describes the file on disk
+    DataFileStamp cached;
+    RunningStats stats;
+    QVERIFY(read_stats_cache(stats_cache_path(m_data_file), cached, stats));
+    QCOMPARE(cached.hash, current.hash);
+    QCOMPARE(stats.total, 19.5);
+    QCOMPARE(stats.monthly_km["2024-01"], 9.5);
+}
+
+QTEST_MAIN(CacheReloadTest)
+#include "test_cache_reload.moc"
@@ -0,0 +1,135 @@
+#include "MainWindow.h"
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QFontDatabase>
+#include <QKeyEvent>
+#include <QStandardPaths>
+#include <algorithm>
+#include <time.h>
+
+class InputLatencyTest : public QObject {
+    Q_OBJECT
+    
+private slots:
+    void initTestCase();
+    void threadedRenderingKeepsKeyLatencyLow();
+    
+private:
+    struct Samples {
+        // Nanoseconds from posting a key press to m_kilometers_entry handling it
+        QVector<qint64> key_latency;
+        // GUI thread CPU nanoseconds spent on the redraw queued ahead of the key
+        QVector<qint64> redraw_cpu;
+    };
+    
+    static Samples measure(MainWindow& window, bool threaded);
+    static qint64 threadCpuNanoseconds();
+    static qint64 percentile(QVector<qint64> samples, double fraction);
+};
+
+void InputLatencyTest::initTestCase() {
+    // Keep the user's data out of the test and start from an empty history
+    QStandardPaths::setTestModeEnabled(true);
+    QString data_file = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) +
+                        "/running_data.txt";
+    QFile::remove(data_file);
+    QFile::remove(stats_cache_path(data_file));
+}
+
+qint64 InputLatencyTest::threadCpuNanoseconds() {
+    // CPU time of the calling thread only, so the render thread cannot skew it
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return static_cast<qint64>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+InputLatencyTest::Samples InputLatencyTest::measure(MainWindow& window, bool threaded) {
+    const int ITERATIONS = 200;
+    
+    TrackWidget *track = window.m_track_widget;
+    QLineEdit *entry = window.m_kilometers_entry;
+    track->setThreadedRendering(threaded);
+    
+    QElapsedTimer clock;
+    clock.start();
+    qint64 handled_at = -1;
+    QMetaObject::Connection connection = QObject::connect(entry, &QLineEdit::textEdited, [&]() {
+        handled_at = clock.nsecsElapsed();
+    });
+    
+    Samples samples;
+    samples.key_latency.reserve(ITERATIONS);
+    samples.redraw_cpu.reserve(ITERATIONS);
+    for (int i = 0; i < ITERATIONS; ++i) {
+        entry->clear();
+        QCoreApplication::processEvents();
+        
+        // A progress change followed by a forced paint, queued ahead of the key
+        // so the key cannot be handled until the GUI thread has redrawn. Only
+        // the synchronous mode draws the track here; threaded mode blits.
+        handled_at = -1;
+        qint64 posted_at = clock.nsecsElapsed();
+        QMetaObject::invokeMethod(track, [&samples, track, i]() {
+            qint64 start = threadCpuNanoseconds();
+            track->setProgress(1.0 + i, 1000.0);
+            track->repaint();
+            samples.redraw_cpu.append(threadCpuNanoseconds() - start);
+        }, Qt::QueuedConnection);
+        QCoreApplication::postEvent(entry, new QKeyEvent(QEvent::KeyPress, Qt::Key_1,
+                                                         Qt::NoModifier, "1"));
+        QCoreApplication::postEvent(entry, new QKeyEvent(QEvent::KeyRelease, Qt::Key_1,
+                                                         Qt::NoModifier, "1"));
+        while (handled_at < 0) {
+            QCoreApplication::processEvents();
+        }
+        samples.key_latency.append(handled_at - posted_at);
+    }
+    
+    QObject::disconnect(connection);
+    return samples;
+}
+
+qint64 InputLatencyTest::percentile(QVector<qint64> samples, double fraction) {
+    std::sort(samples.begin(), samples.end());
+    return samples[static_cast<int>((samples.size() - 1) * fraction)];
+}
+
+void InputLatencyTest::threadedRenderingKeepsKeyLatencyLow() {
+    if (!QFontDatabase::supportsThreadedFontRendering()) {
+        QSKIP("Platform cannot render fonts outside the GUI thread");
+    }
+    
+    MainWindow window;
+    window.resize(1600, 1000);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    
+    // Warm up fonts and paint engines before measuring either mode
+    measure(window, false);
+    
+    Samples synchronous = measure(window, false);
+    Samples threaded = measure(window, true);
+    
+    qint64 sync_redraw = percentile(synchronous.redraw_cpu, 0.5);
+    qint64 threaded_redraw = percentile(threaded.redraw_cpu, 0.5);
+    qint64 sync_latency = percentile(synchronous.key_latency, 0.5);
+    qint64 threaded_latency = percentile(threaded.key_latency, 0.5);
+    qInfo("GUI thread redraw, synchronous: median %.3f ms, threaded: median %.3f ms",
+          sync_redraw / 1e6, threaded_redraw / 1e6);
+    qInfo("key latency while redrawing, synchronous: median %.3f ms, p95 %.3f ms",
+          sync_latency / 1e6, percentile(synchronous.key_latency, 0.95) / 1e6);
+    qInfo("key latency while redrawing, threaded:    median %.3f ms, p95 %.3f ms",
+          threaded_latency / 1e6, percentile(threaded.key_latency, 0.95) / 1e6);
+    
+    // Drawing the track must cost the GUI thread at least twice what blitting
+    // a finished frame does; otherwise the worker is not taking the work
+    QVERIFY2(threaded_redraw * 2 <= sync_redraw,
+             qPrintable(QString("redraw CPU threaded %1 ns vs synchronous %2 ns")
+                            .arg(threaded_redraw).arg(sync_redraw)));
+    QVERIFY2(threaded_latency < sync_latency,
+             qPrintable(QString("key latency threaded %1 ns vs synchronous %2 ns")
+                            .arg(threaded_latency).arg(sync_latency)));
+}
+
+QTEST_MAIN(InputLatencyTest)
+#include "test_input_latency.moc"
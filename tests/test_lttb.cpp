@@ -0,0 +1,87 @@
+#include "Lttb.h"
+#include <QtTest>
+#include <cmath>
+
+namespace {
+
+// Noisy cumulative series with strictly increasing x
+QVector<QPointF> makeSeries(int count) {
+    QVector<QPointF> points;
+    points.reserve(count);
+    double y = 0.0;
+    for (int i = 0; i < count; ++i) {
+        y += 5.0 + 4.0 * std::sin(i * 0.37);
+        points.append(QPointF(i, y));
+    }
+    return points;
+}
+
+}  // namespace
+
+class LttbTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void returnsSmallInputUnchanged();
+    void returnsInputForTinyThreshold();
+    void keepsEndpoints();
+    void outputSizeMatchesThreshold_data();
+    void outputSizeMatchesThreshold();
+    void outputXStrictlyIncreasing();
+    void keepsSpike();
+};
+
+void LttbTest::returnsSmallInputUnchanged() {
+    QVector<QPointF> points = makeSeries(10);
+    QCOMPARE(lttb_downsample(points, 10), points);
+    QCOMPARE(lttb_downsample(points, 50), points);
+}
+
+void LttbTest::returnsInputForTinyThreshold() {
+    QVector<QPointF> points = makeSeries(100);
+    QCOMPARE(lttb_downsample(points, 2), points);
+    QCOMPARE(lttb_downsample(points, 0), points);
+}
+
+void LttbTest::keepsEndpoints() {
+    QVector<QPointF> points = makeSeries(10000);
+    QVector<QPointF> sampled = lttb_downsample(points, 100);
+    QCOMPARE(sampled.first(), points.first());
+    QCOMPARE(sampled.last(), points.last());
+}
+
+void LttbTest::outputSizeMatchesThreshold_data() {
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("threshold");
+    
+    QTest::newRow("minimal") << 1000 << 3;
+    QTest::newRow("one less than input") << 1000 << 999;
+    QTest::newRow("uneven buckets") << 1237 << 97;
+    QTest::newRow("screen width") << 100000 << 1600;
+}
+
+void LttbTest::outputSizeMatchesThreshold() {
+    QFETCH(int, count);
+    QFETCH(int, threshold);
+    
+    QCOMPARE(lttb_downsample(makeSeries(count), threshold).size(), threshold);
+}
+
+void LttbTest::outputXStrictlyIncreasing() {
+    QVector<QPointF> sampled = lttb_downsample(makeSeries(54321), 777);
+    for (int i = 1; i < sampled.size(); ++i) {
+        QVERIFY2(sampled[i].x() > sampled[i - 1].x(), qPrintable(QString::number(i)));
+    }
+}
+
+void LttbTest::keepsSpike() {
+    // A single outlier forms the largest triangle in its bucket
+    QVector<QPointF> points = makeSeries(1000);
+    points[500].setY(points[500].y() + 10000.0);
+    
+    QVector<QPointF> sampled = lttb_downsample(points, 50);
+    QVERIFY(sampled.contains(points[500]));
+}
+
+QTEST_APPLESS_MAIN(LttbTest)
+#include "test_lttb.moc"
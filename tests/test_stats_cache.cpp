@@ -0,0 +1,177 @@
+#include "StatsCache.h"
+#include "DataFile.h"
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+
+class StatsCacheTest : public QObject {
+    Q_OBJECT
+    
+private slots:
+    void init();
+    void cleanup();
+    void freshCacheIsUsed();
+    void sizeChangeInvalidates();
+    void mtimeChangeInvalidates();
+    void sameSizeAndMtimeCaughtByHash();
+    void truncatedSidecarIsIgnored();
+    void wrongVersionIsIgnored();
+    void missingDataFileIgnoresSidecar();
+    
+private:
+    void writeFile(const QString& path, const QByteArray& contents);
+    void setModified(const QString& path, const QDateTime& time);
+    // Writes a sidecar describing the data file as it is now
+    void writeCacheForDataFile();
+    
+    QTemporaryDir *m_dir = nullptr;
+    QString m_data_file;
+    RunningStats m_stats;
+};
+
+void StatsCacheTest::init() {
+    m_dir = new QTemporaryDir();
+    QVERIFY(m_dir->isValid());
+    m_data_file = m_dir->filePath("running_data.txt");
+    
+    m_stats = RunningStats();
+    m_stats.total = 15.5;
+    m_stats.entry_count = 2;
+    m_stats.days_tracked = 32;
+    m_stats.earliest = "2024-01-01";
+    m_stats.latest = "2024-02-01";
+    m_stats.monthly_km["2024-01"] = 5.5;
+    m_stats.monthly_km["2024-02"] = 10.0;
+    
+    writeFile(m_data_file, "2024-01-01,5.5\n2024-02-01,10.0\n");
+    writeCacheForDataFile();
+}
+
+void StatsCacheTest::cleanup() {
+    delete m_dir;
+    m_dir = nullptr;
+}
+
+void StatsCacheTest::writeFile(const QString& path, const QByteArray& contents) {
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QCOMPARE(file.write(contents), qint64(contents.size()));
+}
+
+void StatsCacheTest::setModified(const QString& path, const QDateTime& time) {
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.setFileTime(time, QFileDevice::FileModificationTime));
+}
+
+void StatsCacheTest::writeCacheForDataFile() {
+    DataFileContents data = read_data_file(m_data_file);
+    QVERIFY(data.stamp.exists());
+    QVERIFY(write_stats_cache(stats_cache_path(m_data_file), data.stamp, m_stats));
+}
+
+void StatsCacheTest::freshCacheIsUsed() {
+    DataFileStamp cached;
+    RunningStats stats;
+    QVERIFY(load_stats_cache(m_data_file, cached, stats));
+    
+    QCOMPARE(stats.total, m_stats.total);
+    QCOMPARE(stats.entry_count, m_stats.entry_count);
+    QCOMPARE(stats.days_tracked, m_stats.days_tracked);
+    QCOMPARE(stats.earliest, m_stats.earliest);
+    QCOMPARE(stats.latest, m_stats.latest);
+    QVERIFY(stats.monthly_km == m_stats.monthly_km);
+    
+    QVERIFY(stats_cache_confirmed(cached, read_data_file(m_data_file).stamp));
+}
+
+void StatsCacheTest::sizeChangeInvalidates() {
+    QDateTime modified = QFileInfo(m_data_file).lastModified();
+    writeFile(m_data_file, "2024-01-01,5.5\n2024-02-01,10.0\n2024-03-01,1.0\n");
+    // Keep the mtime so only the size differs
+    setModified(m_data_file, modified);
+    
+    DataFileStamp cached;
+    RunningStats stats;
+    QVERIFY(!load_stats_cache(m_data_file, cached, stats));
+}
+
+void StatsCacheTest::mtimeChangeInvalidates() {
+    setModified(m_data_file, QFileInfo(m_data_file).lastModified().addSecs(60));
+    
+    DataFileStamp cached;
+    RunningStats stats;
+    QVERIFY(!load_stats_cache(m_data_file, cached, stats));
+}
+
+void StatsCacheTest::sameSizeAndMtimeCaughtByHash() {
+    QDateTime modified = QFileInfo(m_data_file).lastModified();
+    // Same length as the original, different distances
+    writeFile(m_data_file, "2024-01-01,9.5\n2024-02-01,10.0\n");
+    setModified(m_data_file, modified);
+    
+    // The cheap startup check cannot tell the difference...
+    DataFileStamp cached;
+    RunningStats stats;
+    QVERIFY(load_stats_cache(m_data_file, cached, stats));
+    
+    // ...but the background load does
+    DataFileContents data = read_data_file(m_data_file);
+    QCOMPARE(data.stamp.size, cached.size);
+    QVERIFY(!stats_cache_confirmed(cached, data.stamp));
+}
+
+void StatsCacheTest::truncatedSidecarIsIgnored() {
+    QString cache_path = stats_cache_path(m_data_file);
+    QFile file(cache_path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QByteArray complete = file.readAll();
+    file.close();
+    
+    // Every cut that loses data must be rejected, including cuts inside a month line
+    int last_line = complete.lastIndexOf("end=");
+    QVERIFY(last_line > 0);
+    for (int length = 0; length < last_line + 5; ++length) {
+        writeFile(cache_path, complete.left(length));
+        DataFileStamp cached;
+        RunningStats stats;
+        QVERIFY2(!load_stats_cache(m_data_file, cached, stats),
+                 qPrintable(QString("accepted cache cut at %1 bytes").arg(length)));
+    }
+}
+
+void StatsCacheTest::wrongVersionIsIgnored() {
+    QString cache_path = stats_cache_path(m_data_file);
+    QFile file(cache_path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QByteArray contents = file.readAll();
+    file.close();
+    
+    int start = contents.indexOf("version=");
+    QVERIFY(start >= 0);
+    int end = contents.indexOf('\n', start);
+    contents.replace(start, end - start, "version=999");
+    writeFile(cache_path, contents);
+    
+    DataFileStamp cached;
+    RunningStats stats;
+    QVERIFY(!load_stats_cache(m_data_file, cached, stats));
+}
+
+void StatsCacheTest::missingDataFileIgnoresSidecar() {
+    QVERIFY(QFile::remove(m_data_file));
+    QVERIFY(QFile::exists(stats_cache_path(m_data_file)));
+    
+    DataFileStamp cached;
+    RunningStats stats;
+    QVERIFY(!load_stats_cache(m_data_file, cached, stats));
+    
+    DataFileContents data = read_data_file(m_data_file);
+    QVERIFY(!data.stamp.exists());
+    QVERIFY(data.entries.empty());
+}
+
+QTEST_GUILESS_MAIN(StatsCacheTest)
+#include "test_stats_cache.moc"
@@ -0,0 +1,146 @@
+#include "StatsServer.h"
+#include <QtTest>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QElapsedTimer>
+#include <thread>
+
+class StatsServerTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void servesPublishedJson();
+    void ignoresQueryString();
+    void unknownPathIsNotFound();
+    void nonGetIsNotAllowed();
+    void publishFromAnotherThreadSwapsBody();
+    void idleClientIsDropped();
+    void bytesAfterRequestAreIgnored();
+
+private:
+    // Sends a raw request and returns everything up to the server closing the connection
+    QByteArray request(const QByteArray& raw);
+    static QByteArray statusLine(const QByteArray& response);
+    static QByteArray body(const QByteArray& response);
+    
+    StatsServer *m_server = nullptr;
+};
+
+void StatsServerTest::init() {
+    m_server = new StatsServer();
+    // Port 0 lets the OS pick a free port
+    QVERIFY(m_server->start(0));
+    QVERIFY(m_server->port() != 0);
+}
+
+void StatsServerTest::cleanup() {
+    delete m_server;
+    m_server = nullptr;
+}
+
+QByteArray StatsServerTest::request(const QByteArray& raw) {
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, m_server->port());
+    if (!socket.waitForConnected(5000)) {
+        return QByteArray();
+    }
+    
+    socket.write(raw);
+    socket.waitForBytesWritten(5000);
+    
+    QByteArray response;
+    while (socket.state() == QAbstractSocket::ConnectedState && socket.waitForReadyRead(5000)) {
+        response += socket.readAll();
+    }
+    response += socket.readAll();
+    return response;
+}
+
+QByteArray StatsServerTest::statusLine(const QByteArray& response) {
+    return response.left(response.indexOf("\r\n"));
+}
+
+QByteArray StatsServerTest::body(const QByteArray& response) {
+    int header_end = response.indexOf("\r\n\r\n");
+    return header_end < 0 ? QByteArray() : response.mid(header_end + 4);
+}
+
+void StatsServerTest::servesPublishedJson() {
+    m_server->publish("{\"total_km\":42}");
+    
+    QByteArray response = request("GET /stats HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    QCOMPARE(statusLine(response), QByteArray("HTTP/1.1 200 OK"));
+    QVERIFY(response.contains("Content-Type: application/json\r\n"));
+    QCOMPARE(body(response), QByteArray("{\"total_km\":42}"));
+    
+    QCOMPARE(body(request("GET / HTTP/1.1\r\n\r\n")), QByteArray("{\"total_km\":42}"));
+}
+
+void StatsServerTest::ignoresQueryString() {
+    m_server->publish("{\"total_km\":7}");
+    
+    QByteArray response = request("GET /stats?t=123 HTTP/1.1\r\n\r\n");
+    QCOMPARE(statusLine(response), QByteArray("HTTP/1.1 200 OK"));
+    QCOMPARE(body(response), QByteArray("{\"total_km\":7}"));
+}
+
+void StatsServerTest::unknownPathIsNotFound() {
+    QByteArray response = request("GET /nope HTTP/1.1\r\n\r\n");
+    QCOMPARE(statusLine(response), QByteArray("HTTP/1.1 404 Not Found"));
+}
+
+void StatsServerTest::nonGetIsNotAllowed() {
+    QByteArray response = request("POST /stats HTTP/1.1\r\nContent-Length: 0\r\n\r\n");
+    QCOMPARE(statusLine(response), QByteArray("HTTP/1.1 405 Method Not Allowed"));
+}
+
+void StatsServerTest::publishFromAnotherThreadSwapsBody() {
+    m_server->publish("{\"total_km\":1}");
+    QCOMPARE(body(request("GET /stats HTTP/1.1\r\n\r\n")), QByteArray("{\"total_km\":1}"));
+    
+    std::thread publisher([this]() {
+        m_server->publish("{\"total_km\":2}");
+    });
+    publisher.join();
+    
+    QCOMPARE(body(request("GET /stats HTTP/1.1\r\n\r\n")), QByteArray("{\"total_km\":2}"));
+}
+
+void StatsServerTest::idleClientIsDropped() {
+    m_server->setIdleTimeout(200);
+    
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, m_server->port());
+    QVERIFY(socket.waitForConnected(5000));
+    
+    // Never send the end of the header block
+    socket.write("GET /stats HTTP/1.1\r\n");
+    QElapsedTimer clock;
+    clock.start();
+    QVERIFY(socket.waitForDisconnected(5000));
+    QVERIFY(clock.elapsed() >= 150);
+}
+
+void StatsServerTest::bytesAfterRequestAreIgnored() {
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, m_server->port());
+    QVERIFY(socket.waitForConnected(5000));
+    
+    socket.write("GET /stats HTTP/1.1\r\n\r\n");
+    QVERIFY(socket.waitForReadyRead(5000));
+    socket.write("GET /nope HTTP/1.1\r\n\r\n");
+    socket.waitForBytesWritten(5000);
+    
+    QByteArray response = socket.readAll();
+    while (socket.state() == QAbstractSocket::ConnectedState && socket.waitForReadyRead(5000)) {
+        response += socket.readAll();
+    }
+    response += socket.readAll();
+    QCOMPARE(response.count("HTTP/1.1 "), 1);
+    QCOMPARE(statusLine(response), QByteArray("HTTP/1.1 200 OK"));
+}
+
+QTEST_GUILESS_MAIN(StatsServerTest)
+#include "test_stats_server.moc"